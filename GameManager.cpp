@@ -1,6 +1,7 @@
 #include "GameManager.h"
 #include "chest.h"
 #include "spawnpoint.h"
+#include "rng.h"
 #include <algorithm>
 #include <random>
 #include <iostream>
@@ -11,6 +12,11 @@ std::atomic<bool> ghostProtection(false);
 std::atomic<bool> ghostsStopped(false);
 Player* globalPlayer = nullptr;
 
+// Ghosts further than this many level-of-detail chunks from the player move
+// at the coarse rate; preset levels fit inside it, big custom mazes do not.
+// A larger view raises it (see setViewSize).
+static const int kGhostLodRadius = 2;
+
 void stop_ghosts_temporarily(int seconds) {
     ghostsStopped = true;
     std::thread([seconds]() {
@@ -37,45 +43,49 @@ void mingdao() {
 }
 
 GameManager::GameManager() 
-    : player(nullptr), ghostManager(nullptr), isPaused(false), 
-      gameOver(false), gameWon(false), difficulty(1), moves(0),
+    : player(nullptr), ghostManager(nullptr), levelPool(nullptr), isPaused(false), 
+      gameOver(false), gameWon(false), difficulty(1),
+      customWidth(0), customHeight(0), ghostCount(0), moves(0),
+      fixedSeed(false), fixedSeedValue(0), levelSeeded(false), levelSeed(0),
+      levelAlgorithm(ALGO_BACKTRACKER), levelTiles(1), levelGhostCount(0), mazeVersion(0), ghostLodRadius(kGhostLodRadius),
+      gameTimeMs(0), lastClockTime(std::chrono::steady_clock::now()), hintEnabled(false),
       lastChestEffectMessage(""),
       lastChestEffectTime(std::chrono::steady_clock::now()) {
     globalPlayer = nullptr;
 }
 
 GameManager::~GameManager() {
+    delete levelPool;
     delete player;
     delete ghostManager;
     globalPlayer = nullptr;
 }
 
-void GameManager::initializeGame(int difficultyLevel) {
+void GameManager::initializeGame(int difficultyLevel, int width, int height) {
     difficulty = difficultyLevel;
+    customWidth = width;
+    customHeight = height;
     moves = 0;
     isPaused = false;
     gameOver = false;
     gameWon = false;
     lastChestEffectMessage.clear();
     
-    // Generate maze
-    mazeGen.setDifficulty(difficulty);
-    mazeGen.generate();
+    // Take a pre-generated level when possible, otherwise build it now
+    Level level;
+    if (levelPool && customWidth == 0 && customHeight == 0 && !fixedSeed && ghostCount == 0) {
+        level = levelPool->acquire(difficulty);
+    } else {
+        if (fixedSeed) mazeGen.setSeed(fixedSeedValue);
+        level = buildLevel(mazeGen, difficulty, customWidth, customHeight, ghostCount);
+    }
+    startLevel(level);
     
     // Create player at start position
     if (player) delete player;
     player = new Player(mazeGen.getStartX(), mazeGen.getStartY());
     globalPlayer = player;
     
-    // Generate chests
-    generateChests();
-    
-    // Initialize ghosts
-    if (ghostManager) delete ghostManager;
-    ghostManager = new GhostManager(difficulty);
-    std::vector<std::vector<char>> maze = mazeGen.getMaze();
-    ghostManager->initializeGhosts(mazeGen.getWidth(), mazeGen.getHeight(), maze);
-    
     // Reset global states
     ghostProtection = false;
     ghostsStopped = false;
@@ -83,32 +93,110 @@ void GameManager::initializeGame(int difficultyLevel) {
     // Reset spawnpoint - set initial spawnpoint at start position
     spawnpoint_set = false;
     mark_spawnpoint(mazeGen.getStartX(), mazeGen.getStartY());
+    updateHint();
+}
+
+void GameManager::startLevel(Level& level) {
+    int mazeWidth = level.maze.getWidth();
+    int mazeHeight = level.maze.getHeight();
+    mazeGen.setMaze(std::move(level.maze), mazeWidth, mazeHeight,
+                    level.startX, level.startY, level.exitX, level.exitY, difficulty);
+    mazeVersion++;
+    pathfinder = std::move(level.paths);
+    resetHint();
+    chests = std::move(level.chests);
+    levelChests = chests;
+
+    levelSeeded = true;
+    levelSeed = level.seed;
+    levelAlgorithm = level.algorithm;
+    levelTiles = level.tilesPerSide;
+    levelGhostCount = level.ghostCount;
+    eventGen = makeRng(levelSeed, RNG_EVENTS);
+
+    // Ghost movement streams come from the level seed as well
+    if (ghostManager) delete ghostManager;
+    ghostManager = new GhostManager(difficulty, levelSeed);
+    ghostManager->setLodRadius(ghostLodRadius);
+    ghostManager->setWalkable(std::move(level.walkable));
+    ghostManager->setCorridors(std::move(level.corridors));
+    ghostManager->initializeGhosts(mazeGen.getMaze(), level.ghostSpawns);
+    markChestsForGhosts();
+    resetGameClock();
+}
+
+void GameManager::markChestsForGhosts() {
+    std::vector<Position> chestPositions;
+    for (const auto& chest : chests) {
+        chestPositions.push_back(posToPosition(chest));
+    }
+    ghostManager->setChests(chestPositions);
+}
+
+void GameManager::resetGameClock() {
+    gameTimeMs = 0;
+    lastClockTime = std::chrono::steady_clock::now();
+}
+
+void GameManager::advanceGameClock() {
+    const auto now = std::chrono::steady_clock::now();
+    if (!ghostsStopped) {
+        gameTimeMs += std::chrono::duration_cast<std::chrono::milliseconds>(now - lastClockTime).count();
+    }
+    lastClockTime = now;
+}
+
+void GameManager::setPaused(bool paused) {
+    isPaused = paused;
+    // Time spent paused does not count
+    if (!paused) lastClockTime = std::chrono::steady_clock::now();
 }
 
 void GameManager::resetGame() {
-    initializeGame(difficulty);
+    initializeGame(difficulty, customWidth, customHeight);
 }
 
-void GameManager::generateChests() {
-    std::vector<std::vector<char>> maze = mazeGen.getMaze();
-    
-    // Use chest generator
-    chests = ChestGenerator::generateChests(
-        maze, 
-        mazeGen.getStartX(), mazeGen.getStartY(),
-        mazeGen.getExitX(), mazeGen.getExitY(),
-        difficulty,
-        'C'
-    );
+void GameManager::setMazeAlgorithm(MazeAlgorithmType type) {
+    mazeGen.setAlgorithm(type);
+    if (levelPool) levelPool->setAlgorithm(type);
+}
+
+void GameManager::setSeed(std::uint64_t seed) {
+    fixedSeed = true;
+    fixedSeedValue = seed;
+}
+
+void GameManager::setGhostCount(int count) {
+    ghostCount = count > 0 ? count : 0;
+}
+
+void GameManager::setViewSize(int width, int height) {
+    // The view is clamped to the maze, so at a maze edge the player can be
+    // a whole view from the opposite side of it. Every chunk within that
+    // distance stays exact, plus one for the player's offset in its chunk.
+    const int reach = std::max(width, height);
+    const int chunks = (reach + GhostManager::kLodChunkCells - 1) / GhostManager::kLodChunkCells + 1;
+    ghostLodRadius = std::max(kGhostLodRadius, chunks);
+    if (ghostManager) ghostManager->setLodRadius(ghostLodRadius);
+}
+
+void GameManager::setUseBitboard(bool enabled) {
+    mazeGen.setUseBitboard(enabled);
+    if (levelPool) levelPool->setUseBitboard(enabled);
+}
+
+void GameManager::enableLevelPool(int workerCount, int levelsPerDifficulty) {
+    delete levelPool;
+    levelPool = new LevelPool(workerCount, levelsPerDifficulty, mazeGen.getAlgorithm());
+    levelPool->setUseBitboard(mazeGen.getUseBitboard());
 }
 
 void GameManager::update() {
     if (isPaused || gameOver || gameWon) return;
     
-    // Update ghosts if not stopped
-    if (!ghostsStopped) {
-        updateGhosts();
-    }
+    // Move the ghosts that are due by now; none while they are frozen
+    advanceGameClock();
+    updateGhosts();
     
     // Check collisions
     checkChestCollision();
@@ -130,6 +218,7 @@ void GameManager::handlePlayerMove(int dx, int dy) {
     if (isValidPosition(newX, newY) && !isWall(newX, newY)) {
         player->setPosition(newX, newY);
         moves++;
+        updateHint();
         update();
     }
 }
@@ -141,19 +230,20 @@ bool GameManager::isValidPosition(int x, int y) const {
 
 bool GameManager::isWall(int x, int y) const {
     if (!isValidPosition(x, y)) return true;
-    const auto& maze = mazeGen.getMaze();
-    return maze[y][x] == '#';
+    return mazeGen.getMaze()(x, y) == '#';
 }
 
 void GameManager::checkChestCollision() {
     int px = player->getX();
     int py = player->getY();
+    if (ghostManager && !ghostManager->getOccupancy().hasChest(px, py)) return;
     
     for (auto it = chests.begin(); it != chests.end(); ++it) {
         if (it->x == px && it->y == py) {
             // Player met a chest
             applyChestBenefit();
             chests.erase(it);
+            if (ghostManager) ghostManager->removeChest(Position(px, py));
             break;
         }
     }
@@ -162,9 +252,7 @@ void GameManager::checkChestCollision() {
 void GameManager::applyChestBenefit() {
     if (!player) return;
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    int effect = gen() % 3 + 1;
+    int effect = eventGen() % 3 + 1;
     
     switch (effect) {
         case 1: {
@@ -193,6 +281,7 @@ void GameManager::removeChestAt(int x, int y) {
             [x, y](const pos& p) { return p.x == x && p.y == y; }),
         chests.end()
     );
+    if (ghostManager) ghostManager->removeChest(Position(x, y));
 }
 
 void GameManager::updateGhosts() {
@@ -200,12 +289,7 @@ void GameManager::updateGhosts() {
     if (ghostsStopped) return;  // Don't update ghosts if they're stopped
     
     Position playerPos(player->getX(), player->getY());
-    std::vector<Position> chestPositions;
-    for (const auto& chest : chests) {
-        chestPositions.push_back(Position(chest.x, chest.y));
-    }
-    
-    ghostManager->updateAllGhosts(playerPos, mazeGen.getMaze(), chestPositions);
+    ghostManager->advanceTo(gameTimeMs, playerPos, mazeGen.getMaze());
 }
 
 void GameManager::checkGhostCollision() {
@@ -234,14 +318,13 @@ void GameManager::setChestEffectMessage(const std::string& message) {
     lastChestEffectTime = std::chrono::steady_clock::now();
 }
 
-std::string GameManager::getActiveChestEffectMessage() const {
-    if (lastChestEffectMessage.empty()) return "";
+const std::string& GameManager::getActiveChestEffectMessage() const {
+    if (lastChestEffectMessage.empty()) return lastChestEffectMessage;
     const auto now = std::chrono::steady_clock::now();
     const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - lastChestEffectTime);
     // Clear message and return empty string if 3 seconds or more have passed
     if (elapsed.count() >= 3) {
         lastChestEffectMessage.clear();
-        return "";
     }
     return lastChestEffectMessage;
 }
@@ -264,17 +347,53 @@ bool GameManager::goToSpawnpoint() {
     
     if (go_to_spawnpoint(newX, newY)) {
         // Check if the spawnpoint position is valid (not a wall)
-        if (isValidPosition(newX, newY) && !isWall(newX, newY)) {
-            player->setPosition(newX, newY);
-            return true;
-        } else {
+        if (!isValidPosition(newX, newY) || isWall(newX, newY)) {
             std::cout << "Warning: Spawnpoint position is invalid (may be a wall)!" << std::endl;
             return false;
         }
+        // ... and that it can be walked to from here
+        if (pathfinder.distance(mazeGen.getMaze(), player->getX(), player->getY(), newX, newY) ==
+            HierarchicalPathfinder::kUnreachable) {
+            std::cout << "Warning: Spawnpoint cannot be reached from here!" << std::endl;
+            return false;
+        }
+        player->setPosition(newX, newY);
+        updateHint();
+        return true;
     }
     return false;
 }
 
+void GameManager::toggleHint() {
+    hintEnabled = !hintEnabled;
+    updateHint();
+}
+
+void GameManager::resetHint() {
+    hintPath.clear();
+    hintCells.assign(mazeGen.getMaze().cellCount(), 0);
+}
+
+void GameManager::updateHint() {
+    // Cells of the hint shown at once; the rest of the route stays as
+    // waypoints until the player gets closer
+    const size_t kHintCells = 400;
+
+    const int width = mazeGen.getWidth();
+    for (const pos& p : hintPath) hintCells[static_cast<size_t>(p.y) * width + p.x] = 0;
+    hintPath.clear();
+    if (!hintEnabled || !player) return;
+
+    // The exit is asked for after every move, so after the first two
+    // queries this only searches the player's cluster
+    const MazeGrid& maze = mazeGen.getMaze();
+    if (!pathfinder.plan(maze, player->getX(), player->getY(), getExitX(), getExitY(), hintRoute)) return;
+    for (size_t i = 0; i + 1 < hintRoute.waypoints.size() && hintPath.size() < kHintCells; ++i) {
+        pathfinder.refineSegment(maze, hintRoute, i, hintPath);
+    }
+    for (const pos& p : hintPath) hintCells[static_cast<size_t>(p.y) * width + p.x] = 1;
+}
+
 int GameManager::getSpawnpointX() const {
     if (!hasSpawnpoint()) return 0;
     extern pos spawnpoint_pos;
@@ -297,23 +416,42 @@ bool GameManager::saveGame(const std::string& filename) {
     state.exitX = mazeGen.getExitX();
     state.exitY = mazeGen.getExitY();
     state.moves = moves;
-    
-    // Convert maze to string lines
-    const auto& maze = mazeGen.getMaze();
-    state.maze_lines.clear();
-    for (const auto& row : maze) {
-        std::string line;
-        for (char c : row) {
-            line += c;
+
+    if (levelSeeded) {
+        // The maze never changes during play, so the only diffs from the
+        // regenerated level are chests collected (or added) since then
+        state.seeded = true;
+        state.seed = levelSeed;
+        state.algorithm = mazeAlgorithmName(levelAlgorithm);
+        state.tilesPerSide = levelTiles;
+        state.ghostCount = levelGhostCount;
+        auto contains = [](const std::vector<pos>& list, const pos& p) {
+            for (const auto& q : list) {
+                if (q.x == p.x && q.y == p.y) return true;
+            }
+            return false;
+        };
+        for (const auto& chest : levelChests) {
+            if (!contains(chests, chest)) state.diffs.push_back(CellDiff{chest.x, chest.y, ' '});
         }
-        state.maze_lines.push_back(line);
-    }
-    
-    // Save chest positions in maze
-    for (const auto& chest : chests) {
-        if (chest.y >= 0 && chest.y < state.height && 
-            chest.x >= 0 && chest.x < state.width) {
-            state.maze_lines[chest.y][chest.x] = 'C';
+        for (const auto& chest : chests) {
+            if (!contains(levelChests, chest)) state.diffs.push_back(CellDiff{chest.x, chest.y, 'C'});
+        }
+    } else {
+        // Convert maze to string lines
+        const MazeGrid& maze = mazeGen.getMaze();
+        state.maze_lines.clear();
+        state.maze_lines.reserve(maze.getHeight());
+        for (int y = 0; y < maze.getHeight(); y++) {
+            state.maze_lines.push_back(maze.rowString(y));
+        }
+
+        // Save chest positions in maze
+        for (const auto& chest : chests) {
+            if (chest.y >= 0 && chest.y < state.height && 
+                chest.x >= 0 && chest.x < state.width) {
+                state.maze_lines[chest.y][chest.x] = 'C';
+            }
         }
     }
     
@@ -328,47 +466,113 @@ bool GameManager::saveGame(const std::string& filename) {
 bool GameManager::loadGame(const std::string& filename) {
     GameState state;
     std::string err;
+    MazeGrid maze;
     
-    if (!loadGameFromFile(filename, state, err)) {
+    // Rows are copied straight from the memory-mapped file into the grid
+    if (!loadMazeFromFile(filename, state, maze, err)) {
         std::cerr << "Load error: " << err << std::endl;
         return false;
     }
     
     difficulty = state.difficulty;
     moves = state.moves;
+
+    if (state.seeded) {
+        // Rebuild the level from its seed, then replay the chest diffs
+        MazeAlgorithmType algorithm;
+        if (!mazeAlgorithmFromName(state.algorithm, algorithm)) {
+            std::cerr << "Load error: unknown maze algorithm " << state.algorithm << std::endl;
+            return false;
+        }
+        MazeGenerator rebuild;
+        rebuild.setAlgorithm(algorithm);
+        if (state.tilesPerSide > 1) rebuild.setTiling(state.tilesPerSide, 1);
+        rebuild.setSeed(state.seed);
+        // With the ghost count of the session that saved it, not this one's
+        Level level = buildLevel(rebuild, difficulty, state.width, state.height, state.ghostCount);
+        if (level.maze.getWidth() != state.width || level.maze.getHeight() != state.height) {
+            std::cerr << "Load error: saved size does not match the rebuilt level" << std::endl;
+            return false;
+        }
+        // A taken chest must be one the level generated, a placed one must
+        // be on floor; anything else would put walls or stray bytes into
+        // the maze behind the indexes built for it
+        for (const CellDiff& d : state.diffs) {
+            bool generatedChest = false;
+            for (const auto& chest : level.chests) {
+                if (chest.x == d.x && chest.y == d.y) generatedChest = true;
+            }
+            if (d.cell == ' ' ? !generatedChest : generatedChest || level.maze(d.x, d.y) != ' ') {
+                std::cerr << "Load error: cell diff at " << d.x << "," << d.y
+                          << " does not match the rebuilt level" << std::endl;
+                return false;
+            }
+        }
+        for (const auto& chest : level.chests) level.maze(chest.x, chest.y) = 'C';
+        for (const CellDiff& d : state.diffs) level.maze(d.x, d.y) = d.cell;
+        std::vector<pos> remaining;
+        for (const auto& chest : level.chests) {
+            if (level.maze(chest.x, chest.y) == 'C') remaining.push_back(chest);
+        }
+        for (const CellDiff& d : state.diffs) {
+            if (d.cell == 'C') remaining.push_back(pos{d.x, d.y});
+        }
+        for (const auto& chest : remaining) level.maze(chest.x, chest.y) = ' ';
+        std::vector<pos> generated = level.chests;
+        for (const auto& chest : generated) level.walkable.insert(chest.x, chest.y);
+        level.chests = remaining;
+        level.startX = state.playerX;
+        level.startY = state.playerY;
+        level.exitX = state.exitX;
+        level.exitY = state.exitY;
+        startLevel(level);
+        levelChests = generated;
+
+        if (player) delete player;
+        player = new Player(state.playerX, state.playerY);
+        globalPlayer = player;
+        updateHint();
+
+        isPaused = false;
+        gameOver = false;
+        gameWon = false;
+        return true;
+    }
     
-    // Reconstruct maze
-    std::vector<std::vector<char>> maze;
+    // Pull chests out of the maze
     chests.clear();
-    
     for (int y = 0; y < state.height; y++) {
-        std::vector<char> row;
         for (int x = 0; x < state.width; x++) {
-            char c = state.maze_lines[y][x];
-            if (c == 'C') {
+            if (maze(x, y) == 'C') {
                 chests.push_back(pos{x, y});
-                row.push_back(' ');
-            } else {
-                row.push_back(c);
+                maze(x, y) = ' ';
             }
         }
-        maze.push_back(row);
     }
     
     // Set up maze generator with loaded maze
     // Note: Start position is where player was saved, exit is at exitX/exitY
     mazeGen.setMaze(maze, state.width, state.height, 
                     state.playerX, state.playerY, state.exitX, state.exitY, difficulty);
+    mazeVersion++;
+    pathfinder.build(mazeGen.getMaze());
+    resetHint();
     
     // Create player
     if (player) delete player;
     player = new Player(state.playerX, state.playerY);
     globalPlayer = player;
+    updateHint();
     
     // Initialize ghosts
     if (ghostManager) delete ghostManager;
     ghostManager = new GhostManager(difficulty);
-    ghostManager->initializeGhosts(state.width, state.height, maze);
+    ghostManager->setLodRadius(ghostLodRadius);
+    ghostManager->initializeGhosts(maze, ghostManager->planGhostSpawns(state.width, state.height, maze, ghostCount));
+    markChestsForGhosts();
+    resetGameClock();
+    levelSeeded = false;
+    eventGen = makeRng(randomSeed(), RNG_EVENTS);
     
     isPaused = false;
     gameOver = false;
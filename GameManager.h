@@ -8,7 +8,11 @@
 #include "chest.h"
 #include "fileio.h"
 #include "spawnpoint.h"
+#include "level_pool.h"
+#include "hpa_pathfinder.h"
 #include "pos.h"
+#include <cstdint>
+#include <random>
 #include <vector>
 #include <atomic>
 #include <thread>
@@ -32,14 +36,44 @@ private:
     MazeGenerator mazeGen;
     Player* player;
     GhostManager* ghostManager;
+    LevelPool* levelPool;   // optional background level pre-generation
     std::vector<pos> chests;
+    HierarchicalPathfinder pathfinder;
     
     // Game state
     bool isPaused;
     bool gameOver;
     bool gameWon;
     int difficulty;
+    int customWidth;   // 0 = use the difficulty preset
+    int customHeight;
+    int ghostCount;    // 0 = the difficulty's default
     int moves;
+
+    // Level seed: every level is rebuilt exactly from it (see rng.h)
+    bool fixedSeed;                 // --seed given: every level uses fixedSeedValue
+    std::uint64_t fixedSeedValue;
+    bool levelSeeded;               // false for levels loaded from full-maze saves
+    std::uint64_t levelSeed;
+    MazeAlgorithmType levelAlgorithm;
+    int levelTiles;
+    int levelGhostCount;            // 0 = the difficulty's default
+    std::vector<pos> levelChests;   // chests as generated, for save diffs
+    std::uint32_t mazeVersion;      // bumped whenever the maze is replaced
+    int ghostLodRadius;             // in chunks; covers the view
+    std::mt19937 eventGen;          // RNG_EVENTS stream of levelSeed
+
+    // Game time that drives the ghosts: runs while playing, stands still
+    // while paused or while ghosts are frozen
+    std::int64_t gameTimeMs;
+    std::chrono::steady_clock::time_point lastClockTime;
+
+    // Exit hint: the stretch of the path to the exit ahead of the player
+    bool hintEnabled;
+    HierarchicalPathfinder::Route hintRoute;
+    std::vector<pos> hintPath;
+    std::vector<std::uint8_t> hintCells;    // per cell, 1 on hintPath
+
     mutable std::string lastChestEffectMessage;
     mutable std::chrono::steady_clock::time_point lastChestEffectTime;
     
@@ -51,10 +85,33 @@ public:
     ~GameManager();
     
     // Game initialization
-    void initializeGame(int difficultyLevel);
+    // A non-zero width/height overrides the difficulty's preset maze size
+    void initializeGame(int difficultyLevel, int width = 0, int height = 0);
     void resetGame();
+    // Maze carving strategy for subsequent games
+    void setMazeAlgorithm(MazeAlgorithmType type);
+    // Run maze post-processing on the bit-packed kernels (same mazes, faster)
+    void setUseBitboard(bool enabled);
+    // Build every level from this seed instead of a random one; such
+    // levels bypass the level pool
+    void setSeed(std::uint64_t seed);
+    // Ghosts per level instead of the difficulty's 1/3/5 (0 restores the
+    // default); such levels bypass the level pool
+    void setGhostCount(int count);
+    std::uint64_t getLevelSeed() const { return levelSeed; }
+    // Changes whenever a new maze is put in place, so views can cache what
+    // they derive from it
+    std::uint32_t getMazeVersion() const { return mazeVersion; }
+    // Cells of the maze on screen; ghosts that can be seen always move at
+    // their exact pace, however large the view
+    void setViewSize(int width, int height);
+    // Pre-generate preset levels on background workers so new games and
+    // restarts start instantly; custom sizes are still built synchronously
+    void enableLevelPool(int workerCount, int levelsPerDifficulty);
+    const LevelPool* getLevelPool() const { return levelPool; }
     
-    // Game loop
+    // Game loop. Call update often (every frame): ghosts move on game time,
+    // never faster for being updated more often.
     void update();
     void handlePlayerMove(int dx, int dy);
     
@@ -71,21 +128,29 @@ public:
     void markSpawnpoint();
     bool goToSpawnpoint();
     bool hasSpawnpoint() const { return spawnpoint_set; }
+
+    // Exit hint
+    void toggleHint();
+    bool isHintEnabled() const { return hintEnabled; }
+    bool isHintCell(int x, int y) const {
+        return !hintCells.empty() && hintCells[static_cast<size_t>(y) * mazeGen.getWidth() + x];
+    }
     
     // Game state
     bool isGamePaused() const { return isPaused; }
     bool isGameOver() const { return gameOver; }
     bool isGameWon() const { return gameWon; }
-    void setPaused(bool paused) { isPaused = paused; }
+    void setPaused(bool paused);
     
-    // Save/Load
+    // Save/Load. Generated levels are saved as their seed plus chest
+    // changes; levels loaded from full-maze saves are saved in full.
     bool saveGame(const std::string& filename = "savegame.txt");
     bool loadGame(const std::string& filename = "savegame.txt");
     
     // Getters
-    const std::vector<std::vector<char>>& getMaze() const { return mazeGen.getMaze(); }
+    const MazeGrid& getMaze() const { return mazeGen.getMaze(); }
     Player* getPlayer() const { return player; }
-    const std::vector<Ghost>& getGhosts() const { return ghostManager->getGhosts(); }
+    const GhostManager* getGhostManager() const { return ghostManager; }
     const std::vector<pos>& getChests() const { return chests; }
     int getDifficulty() const { return difficulty; }
     int getMoves() const { return moves; }
@@ -96,7 +161,8 @@ public:
     int getExitX() const { return mazeGen.getExitX(); }
     int getExitY() const { return mazeGen.getExitY(); }
     bool isPlayerShielded() const;
-    std::string getActiveChestEffectMessage() const;
+    // Empty once the message is three seconds old
+    const std::string& getActiveChestEffectMessage() const;
     
     // Spawnpoint getters
     int getSpawnpointX() const;
@@ -107,7 +173,19 @@ public:
     bool isWall(int x, int y) const;
     
 private:
-    void generateChests();
+    // Install level as the current game: maze, chests, player, ghosts
+    void startLevel(Level& level);
+    // Mark every chest as blocking in the ghost manager's occupancy grid
+    void markChestsForGhosts();
+    // Restart game time at 0 for a new set of ghosts
+    void resetGameClock();
+    // Add the real time since the last call to game time, unless the
+    // ghosts are frozen
+    void advanceGameClock();
+    // Forget the hint of the previous maze
+    void resetHint();
+    // Recompute the hint from the player's position
+    void updateHint();
     void convertChestPositions();
     Position posToPosition(const pos& p) const;
     pos positionToPos(const Position& p) const;
@@ -6,118 +6,552 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <charconv>
 #include <cstdlib>
+#include <string>
 
-GameRenderer::GameRenderer() {
+namespace {
+
+// Palette of the maze cells, by CellColor. Each code is a complete SGR
+// sequence starting with a reset, so a run can begin anywhere without
+// depending on the attributes set before it.
+constexpr std::string_view kCellColors[] = {
+    "\033[0;48;5;235;38;5;240m",     // wall: dark gray background
+    "\033[0;48;5;233;38;5;248m",     // path: dark background
+    "\033[0;1;32;48;5;233m",         // player: bright green
+    "\033[0;1;36;48;5;233m",         // shielded player: bright cyan
+    "\033[0;1;31;48;5;233m",         // ghost: bright red
+    "\033[0;1;33;48;5;233m",         // chest: bright yellow
+    "\033[0;1;34;48;5;233m",         // exit: bright blue
+    "\033[0;1;35;48;5;233m",         // spawnpoint: bright magenta
+    "\033[0;48;5;233;38;5;37m",      // hint: teal on path background
+    "\033[0;48;5;234;38;5;243m",     // minimap
+    "\033[0;48;5;237;38;5;250m",     // minimap, inside the view
+    "\033[0m",                       // blank
+};
+
+// ASCII mode: the same colors cut down to the 16-color codes
+constexpr std::string_view kAsciiColors[] = {
+    "\033[0;90m",                    // wall: gray
+    "\033[0m",                       // path
+    "\033[0;1;32m",                  // player: bright green
+    "\033[0;1;36m",                  // shielded player: bright cyan
+    "\033[0;1;31m",                  // ghost: bright red
+    "\033[0;1;33m",                  // chest: bright yellow
+    "\033[0;1;34m",                  // exit: bright blue
+    "\033[0;1;35m",                  // spawnpoint: bright magenta
+    "\033[0;36m",                    // hint: cyan
+    "\033[0;90m",                    // minimap
+    "\033[0;37m",                    // minimap, inside the view
+    "\033[0m",                       // blank
+};
+
+// Half-block mode: each tile is one solid 256-color index, 0 standing for
+// the terminal's default. Minimap blocks are shaded by their glyph instead.
+const std::uint8_t kHalfColors[] = {
+    240,    // wall
+    233,    // path
+    46,     // player
+    51,     // shielded player
+    196,    // ghost
+    226,    // chest
+    33,     // exit
+    201,    // spawnpoint
+    37,     // hint
+    0,      // minimap (by shade)
+    0,      // minimap, inside the view (by shade)
+    0,      // blank
+};
+
+// Screen size used when the terminal's is unknown: large enough for any
+// maze, so the whole of it is drawn
+const int kUnlimited = 1 << 20;
+
+// Unchanged cells between two changed ones are rewritten rather than
+// jumped over when the gap is this short; a cursor move costs about as
+// much as a wall cell
+const int kMaxRunGap = 1;
+
+// Synchronized update (DEC mode 2026): the terminal holds the frame until
+// the end marker, so a half-written diff is never shown. Terminals without
+// it ignore both sequences.
+constexpr std::string_view kBeginUpdate = "\033[?2026h";
+constexpr std::string_view kEndUpdate = "\033[?2026l";
+
+void appendGlyph(FrameEncoder& out, char glyph) {
+    switch (glyph) {
+        case '#': out.append("██"); break;
+        case '.': out.append("··"); break;
+        case '>': out.append("><"); break;
+        case '$': out.append("$ "); break;
+        case '1': out.append("░░"); break;
+        case '2': out.append("▒▒"); break;
+        case '3': out.append("▓▓"); break;
+        default:
+            out.append(glyph);
+            out.append(glyph);
+            break;
+    }
+}
+
+char asciiGlyph(char glyph) {
+    switch (glyph) {
+        case '1': return ':';
+        case '2': return '+';
+        case '3': return '%';
+        default: return glyph;
+    }
+}
+
+// Appends the decimal digits of value to a UI line
+void appendNumber(std::string& line, long value) {
+    char digits[24];
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    line.append(digits, static_cast<size_t>(result.ptr - digits));
+}
+
+} // namespace
+
+const char* renderModeName(RenderMode mode) {
+    switch (mode) {
+        case RENDER_BLOCKS: return "blocks";
+        case RENDER_HALF: return "half";
+        case RENDER_ASCII: return "ascii";
+        default: return "unknown";
+    }
+}
+
+bool renderModeFromName(const std::string& name, RenderMode& mode) {
+    const RenderMode all[] = {RENDER_BLOCKS, RENDER_HALF, RENDER_ASCII};
+    for (RenderMode m : all) {
+        if (name == renderModeName(m)) {
+            mode = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+GameRenderer::GameRenderer()
+    : mode(RENDER_BLOCKS), cellColumns(2), frameWidth(0), frameHeight(0), screenRows(0), outputFd(FrameEncoder::kStdoutFd), fullRedraw(true), uiStale(true),
+      debugHud(false), fullRedraws(0), screen{0, 0}, screenKnown(false), fixedScreen(false),
+      viewX(0), viewY(0), viewWidth(0), viewHeight(0), viewMazeVersion(0), viewPlaced(false),
+      minimap(false), pyramidMazeVersion(0), minimapLevel(0), minimapWidth(0), minimapHeight(0) {
 }
 
 GameRenderer::~GameRenderer() {
-    // Restore terminal on exit: reset colors and show cursor
-    std::cout << resetColor() << "\033[?25h";
+    // Restore terminal on exit: reset colors, show cursor, wrap lines again
+    std::cout << resetColor() << "\033[?25h\033[?7h";
 }
 
 void GameRenderer::initialize() {
-    // Hide cursor for smoother display
-    std::cout << "\033[?25l";
+    // Hide cursor for smoother display, and keep lines wider than the
+    // terminal from wrapping (and scrolling the screen at the bottom)
+    std::cout << "\033[?25l\033[?7l";
     clearScreen();
+
+    // Frames fit the terminal and follow it when it is resized
+    watchTerminalResize();
+    if (!fixedScreen) screenKnown = queryTerminalSize(outputFd, screen);
+}
+
+void GameRenderer::setScreenSize(int cols, int rows) {
+    fixedScreen = cols > 0 && rows > 0;
+    if (fixedScreen) {
+        screen = TerminalSize{cols, rows};
+        screenKnown = true;
+    } else {
+        screenKnown = queryTerminalSize(outputFd, screen);
+    }
+    invalidate();
+}
+
+void GameRenderer::setRenderMode(RenderMode newMode) {
+    mode = newMode;
+    cellColumns = mode == RENDER_BLOCKS ? 2 : 1;
+    // The same screen holds a different number of tiles
+    frameWidth = frameHeight = 0;
+    invalidate();
 }
 
 void GameRenderer::clearScreen() {
     // Initial clear when starting the game
     std::cout << "\033[2J\033[H";
     std::cout.flush();
+    invalidate();
+}
+
+void GameRenderer::invalidate() {
+    fullRedraw = true;
 }
 
 /**
  * Render the main game screen.
- * Uses buffered output and cursor repositioning to reduce flicker.
+ * The frame is built into a back buffer of cells and compared with what is
+ * on screen; only runs of changed cells are encoded, each after a cursor
+ * jump, inside one synchronized update that goes out in a single write.
+ * Only the maze cells in the view are looked at, so the cost follows the
+ * screen size rather than the maze size.
  */
 void GameRenderer::renderGame(const GameManager& game) {
-    std::ostringstream screenBuffer;
+    if (terminalResized()) {
+        // Whatever was on screen has been reflowed by the terminal
+        if (!fixedScreen) screenKnown = queryTerminalSize(outputFd, screen);
+        fullRedraw = true;
+    }
+    if (!layoutFrame(game)) {
+        backCells.assign(static_cast<size_t>(frameWidth) * frameHeight, Cell{' ', CELL_BLANK});
+        if (mode == RENDER_HALF) halfCells.assign(static_cast<size_t>(frameWidth) * screenRows, Cell{0, 0});
+        fullRedraw = true;
+    }
+    followPlayer(game);
+
+    encoder.clear();
+    encoder.append(kBeginUpdate);
+
+    const bool full = fullRedraw;
+    if (fullRedraw) {
+        // Clear whatever else is on screen and mark every cell stale
+        encoder.append(resetColor());
+        encoder.append("\033[2J");
+        frontCells.assign(static_cast<size_t>(frameWidth) * screenRows, Cell{' ', CELL_UNKNOWN});
+        uiStale = true;
+        fullRedraw = false;
+        fullRedraws++;
+    }
+
+    // The UI lines are laid out first so the debug HUD shows the frame
+    // before this one
+    buildFrame(game);
+    drawUI(game, uiLines);
 
-    // Move cursor to top-left without clearing the screen
-    screenBuffer << "\033[H";
+    const auto encodeStart = std::chrono::steady_clock::now();
+    lastFrame = FrameStats();
+    lastFrame.full = full;
+    diffFrame(encoder, composeScreen());
+    diffUI(encoder);
 
-    const int bufferWidth = game.getWidth() + 2;
+    // Overlays are drawn over the maze; what they cover is repainted on the
+    // first frame after they are gone
+    if (game.isGamePaused()) drawPauseOverlay(encoder);
+    if (game.isGameOver()) drawGameOver(game, encoder);
 
-    // Draw top border
-    std::string topBorder = colorWall();
-    for (int i = 0; i < bufferWidth; i++) {
-        topBorder += "██";
+    if (encoder.size() == kBeginUpdate.size()) {
+        // Nothing changed: write nothing at all
+        encoder.clear();
+        lastFrame.bytes = 0;
+        return;
     }
-    topBorder += resetColor();
-    screenBuffer << topBorder << "\n";
+    encoder.append(kEndUpdate);
+    lastFrame.bytes = encoder.size();
+    lastFrame.encodeUs = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - encodeStart).count();
 
-    // Draw maze rows
-    for (int y = 0; y < game.getHeight(); y++) {
-        std::string row = colorWall() + "█";
-        for (int x = 0; x < game.getWidth(); x++) {
-            // Player rendering
-            const Player* player = game.getPlayer();
-            if (player && player->getX() == x && player->getY() == y) {
-                row += game.isPlayerShielded() ? colorPlayerShield() + "@@" : colorPlayer() + "@@";
-                continue;
-            }
+    // Anything still buffered in std::cout (the menu, a warning) goes
+    // first, then the frame in one write
+    std::cout.flush();
+    encoder.flush(outputFd);
+}
 
-            // Ghost rendering
-            bool ghostFound = false;
-            for (const auto& ghost : game.getGhosts()) {
-                Position pos = ghost.getPosition();
-                if (pos.x == x && pos.y == y) {
-                    row += colorGhost() + std::string(2, ghost.getDisplayChar());
-                    ghostFound = true;
-                    break;
-                }
-            }
-            if (ghostFound) continue;
+bool GameRenderer::layoutFrame(const GameManager& game) {
+    const int width = game.getWidth();
+    const int height = game.getHeight();
+    const int uiRows = debugHud ? 5 : 4;
+    // Tiles that fit on screen: half-block mode puts two on each row
+    const int tilesAcross = screenKnown ? screen.cols / cellColumns : kUnlimited;
+    const int rowsDown = screenKnown ? (screen.rows - uiRows) * (mode == RENDER_HALF ? 2 : 1) : kUnlimited;
 
-            // Exit rendering
-            if (game.getExitX() == x && game.getExitY() == y) {
-                row += colorExit() + "><";
-                continue;
+    int newViewWidth = std::min(width, tilesAcross - 2);
+    int newViewHeight = std::min(height, rowsDown - 2);
+    minimapWidth = minimapHeight = 0;
+    if (minimap && (newViewWidth < width || newViewHeight < height)) {
+        if (pyramid.empty() || pyramidMazeVersion != game.getMazeVersion()) {
+            pyramid.build(game.getMaze());
+            pyramidMazeVersion = game.getMazeVersion();
+        }
+        // Up to a quarter of the width, as tall as the view may be
+        const int maxWidth = std::max(4, tilesAcross / 4);
+        const int maxHeight = std::max(1, rowsDown - 2);
+        minimapLevel = pyramid.levelToFit(maxWidth, maxHeight);
+        minimapWidth = std::min(pyramid.levelWidth(minimapLevel), maxWidth);
+        minimapHeight = std::min(pyramid.levelHeight(minimapLevel), maxHeight);
+        newViewWidth = std::min(width, tilesAcross - 3 - minimapWidth);
+    }
+    viewWidth = std::max(1, newViewWidth);
+    viewHeight = std::max(1, newViewHeight);
+
+    // The view, its border and the minimap beside it sharing one border
+    const int newFrameWidth = viewWidth + 2 + (minimapWidth ? minimapWidth + 1 : 0);
+    const int newFrameHeight = std::max(viewHeight, minimapHeight) + 2;
+    if (newFrameWidth == frameWidth && newFrameHeight == frameHeight) return true;
+    frameWidth = newFrameWidth;
+    frameHeight = newFrameHeight;
+    screenRows = mode == RENDER_HALF ? (frameHeight + 1) / 2 : frameHeight;
+    return false;
+}
+
+void GameRenderer::followPlayer(const GameManager& game) {
+    const Player* player = game.getPlayer();
+    const int width = game.getWidth();
+    const int height = game.getHeight();
+    const int px = player ? player->getX() : 0;
+    const int py = player ? player->getY() : 0;
+
+    // Jumping to center the player when it nears an edge moves the view
+    // seldom, and every move rewrites most of the screen
+    const int marginX = viewWidth / 4;
+    const int marginY = viewHeight / 4;
+    if (!viewPlaced || viewMazeVersion != game.getMazeVersion() ||
+        px < viewX + marginX || px > viewX + viewWidth - 1 - marginX) {
+        viewX = px - viewWidth / 2;
+    }
+    if (!viewPlaced || viewMazeVersion != game.getMazeVersion() ||
+        py < viewY + marginY || py > viewY + viewHeight - 1 - marginY) {
+        viewY = py - viewHeight / 2;
+    }
+    viewX = std::max(0, std::min(viewX, width - viewWidth));
+    viewY = std::max(0, std::min(viewY, height - viewHeight));
+    viewPlaced = true;
+    viewMazeVersion = game.getMazeVersion();
+}
+
+void GameRenderer::buildFrame(const GameManager& game) {
+    const auto& maze = game.getMaze();
+    const Cell wall{'#', CELL_WALL};
+
+    // Border around the view (and the minimap), blank below a shorter view
+    std::fill(backCells.begin(), backCells.end(), Cell{' ', CELL_BLANK});
+    for (int x = 0; x < frameWidth; x++) {
+        backCells[x] = wall;
+        backCells[static_cast<size_t>(frameHeight - 1) * frameWidth + x] = wall;
+    }
+    for (int y = 1; y < frameHeight - 1; y++) {
+        Cell* row = &backCells[static_cast<size_t>(y) * frameWidth];
+        row[0] = wall;
+        row[viewWidth + 1] = wall;
+        row[frameWidth - 1] = wall;
+    }
+
+    // One linear pass over the maze cells in view, with the exit hint
+    const int visibleWidth = std::min(viewWidth, game.getWidth());
+    const int visibleHeight = std::min(viewHeight, game.getHeight());
+    for (int vy = 0; vy < visibleHeight; vy++) {
+        const int y = viewY + vy;
+        Cell* row = &backCells[static_cast<size_t>(vy + 1) * frameWidth + 1];
+        for (int vx = 0; vx < visibleWidth; vx++) {
+            const int x = viewX + vx;
+            if (maze(x, y) == '#') {
+                row[vx] = wall;
+            } else {
+                row[vx] = game.isHintCell(x, y) ? Cell{'.', CELL_HINT} : Cell{' ', CELL_PATH};
             }
+        }
+    }
 
-            // Chest rendering
-            bool chestFound = false;
-            for (const auto& chest : game.getChests()) {
-                if (chest.x == x && chest.y == y) {
-                    row += colorChest() + "$ ";
-                    chestFound = true;
-                    break;
-                }
+    // Entities are stamped on top once each, lowest priority first, so a
+    // cell shows the same one the per-cell checks used to pick: player,
+    // then ghost, exit, chest, spawnpoint. Those outside the view are
+    // skipped.
+    auto stamp = [this, visibleWidth, visibleHeight](int x, int y, Cell cell) {
+        x -= viewX;
+        y -= viewY;
+        if (x < 0 || y < 0 || x >= visibleWidth || y >= visibleHeight) return;
+        backCells[static_cast<size_t>(y + 1) * frameWidth + x + 1] = cell;
+    };
+
+    if (game.hasSpawnpoint()) stamp(game.getSpawnpointX(), game.getSpawnpointY(), Cell{'*', CELL_SPAWNPOINT});
+    for (const auto& chest : game.getChests()) stamp(chest.x, chest.y, Cell{'$', CELL_CHEST});
+    stamp(game.getExitX(), game.getExitY(), Cell{'>', CELL_EXIT});
+
+    // Where ghosts share a cell the lowest id shows, so stamp from the top
+    if (const GhostManager* ghosts = game.getGhostManager()) {
+        const std::vector<Position>& positions = ghosts->getPositions();
+        for (size_t id = positions.size(); id-- > 0;) {
+            const char glyph = ghostDisplayChar(ghosts->getGhostType(static_cast<int>(id)));
+            stamp(positions[id].x, positions[id].y, Cell{glyph, CELL_GHOST});
+        }
+    }
+
+    if (const Player* player = game.getPlayer()) {
+        stamp(player->getX(), player->getY(),
+              Cell{'@', game.isPlayerShielded() ? CELL_PLAYER_SHIELD : CELL_PLAYER});
+    }
+
+    if (minimapWidth > 0) buildMinimap(game);
+}
+
+void GameRenderer::buildMinimap(const GameManager& game) {
+    const int scale = pyramid.levelScale(minimapLevel);
+    const int left = viewWidth + 2;
+    auto at = [this, left](int mx, int my) -> Cell& {
+        return backCells[static_cast<size_t>(my + 1) * frameWidth + left + mx];
+    };
+
+    // Shade by how open each block is; blocks overlapping the view are lit
+    for (int my = 0; my < minimapHeight; my++) {
+        const bool rowInView = (my + 1) * scale > viewY && my * scale < viewY + viewHeight;
+        for (int mx = 0; mx < minimapWidth; mx++) {
+            const bool inView = rowInView && (mx + 1) * scale > viewX && mx * scale < viewX + viewWidth;
+            const int open = pyramid.openness(minimapLevel, mx, my);
+            const char glyph = open < 52 ? '#' : open < 103 ? '3' : open < 154 ? '2' : open < 205 ? '1' : ' ';
+            at(mx, my) = Cell{glyph, inView ? CELL_MINIMAP_VIEW : CELL_MINIMAP};
+        }
+    }
+
+    auto mark = [&](int x, int y, Cell cell) {
+        x /= scale;
+        y /= scale;
+        if (x < minimapWidth && y < minimapHeight) at(x, y) = cell;
+    };
+    mark(game.getExitX(), game.getExitY(), Cell{'>', CELL_EXIT});
+    if (const Player* player = game.getPlayer()) mark(player->getX(), player->getY(), Cell{'@', CELL_PLAYER});
+}
+
+const std::vector<GameRenderer::Cell>& GameRenderer::composeScreen() {
+    if (mode != RENDER_HALF) return backCells;
+
+    // Each screen cell is a column of two tiles, reduced to their colors
+    auto shade = [](const Cell& tile) -> std::uint8_t {
+        if (tile.color == CELL_MINIMAP || tile.color == CELL_MINIMAP_VIEW) {
+            // Grays by openness, lighter inside the view
+            const bool inView = tile.color == CELL_MINIMAP_VIEW;
+            switch (tile.glyph) {
+                case '#': return inView ? 239 : 236;
+                case '3': return inView ? 241 : 238;
+                case '2': return inView ? 244 : 240;
+                case '1': return inView ? 247 : 242;
+                case '@': return kHalfColors[CELL_PLAYER];
+                case '>': return kHalfColors[CELL_EXIT];
+                default: return inView ? 250 : 244;
             }
-            if (chestFound) continue;
+        }
+        return kHalfColors[tile.color];
+    };
+    for (int r = 0; r < screenRows; r++) {
+        const Cell* upper = &backCells[static_cast<size_t>(2 * r) * frameWidth];
+        const Cell* lower = 2 * r + 1 < frameHeight ? upper + frameWidth : nullptr;
+        Cell* out = &halfCells[static_cast<size_t>(r) * frameWidth];
+        for (int x = 0; x < frameWidth; x++) {
+            out[x] = Cell{static_cast<char>(shade(upper[x])), lower ? shade(lower[x]) : std::uint8_t(0)};
+        }
+    }
+    return halfCells;
+}
 
-            // Spawnpoint rendering
-            if (game.hasSpawnpoint() && game.getSpawnpointX() == x && game.getSpawnpointY() == y) {
-                row += colorSpawnpoint() + "**";
+void GameRenderer::diffFrame(FrameEncoder& out, const std::vector<Cell>& back) {
+    for (int y = 0; y < screenRows; y++) {
+        const size_t rowStart = static_cast<size_t>(y) * frameWidth;
+        int x = 0;
+        while (x < frameWidth) {
+            if (back[rowStart + x] == frontCells[rowStart + x]) {
+                x++;
                 continue;
             }
+            // Extend the run over changed cells and short unchanged gaps
+            int last = x;
+            for (int next = x + 1; next < frameWidth && next - last <= kMaxRunGap + 1; next++) {
+                if (back[rowStart + next] != frontCells[rowStart + next]) last = next;
+            }
 
-            // Default: wall or path
-            const auto& maze = game.getMaze();
-            row += (maze[y][x] == '#') ? colorWall() + "██" : colorPath() + "  ";
+            out.moveTo(y + 1, cellColumns * x + 1);
+            lastFrame.runs++;
+            for (; x <= last; x++) {
+                const Cell& cell = back[rowStart + x];
+                Cell& shown = frontCells[rowStart + x];
+                if (cell != shown) lastFrame.changedCells++;
+                encodeCell(out, cell);
+                shown = cell;
+            }
         }
-        row += colorWall() + "█" + resetColor();
-        screenBuffer << row << "\n";
     }
+    if (out.getPen() != FrameEncoder::kNoPen) {
+        out.append(resetColor());
+        out.resetPen();
+    }
+}
 
-    // Draw bottom border
-    std::string bottomBorder = colorWall();
-    for (int i = 0; i < bufferWidth; i++) {
-        bottomBorder += "██";
+void GameRenderer::encodeCell(FrameEncoder& out, const Cell& cell) {
+    switch (mode) {
+        case RENDER_BLOCKS:
+            out.setPen(cell.color, kCellColors[cell.color]);
+            appendGlyph(out, cell.glyph);
+            break;
+        case RENDER_ASCII:
+            out.setPen(cell.color, kAsciiColors[cell.color]);
+            out.append(asciiGlyph(cell.glyph));
+            break;
+        case RENDER_HALF: {
+            // Upper tile in the foreground of "▀", lower in the background;
+            // a cell of one color is a space on that background
+            const std::uint8_t upper = static_cast<std::uint8_t>(cell.glyph);
+            const std::uint8_t lower = cell.color;
+            if (upper == lower) {
+                if (out.changePen(0x10000u | lower)) {
+                    out.append("\033[0");
+                    if (lower) {
+                        out.append(";48;5;");
+                        out.appendInt(lower);
+                    }
+                    out.append('m');
+                }
+                out.append(' ');
+            } else {
+                if (out.changePen((static_cast<std::uint32_t>(upper) << 8) | lower)) {
+                    out.append("\033[0");
+                    if (upper) {
+                        out.append(";38;5;");
+                        out.appendInt(upper);
+                    }
+                    if (lower) {
+                        out.append(";48;5;");
+                        out.appendInt(lower);
+                    }
+                    out.append('m');
+                }
+                out.append("▀");
+            }
+            break;
+        }
     }
-    bottomBorder += resetColor();
-    screenBuffer << bottomBorder << "\n";
+}
 
-    // Draw UI and overlays
-    drawUI(game, screenBuffer);
-    if (game.isGamePaused()) drawPauseOverlay(screenBuffer);
-    if (game.isGameOver()) drawGameOver(game, screenBuffer);
+void GameRenderer::diffUI(FrameEncoder& out) {
+    for (size_t i = 0; i < uiLines.size(); i++) {
+        if (!uiStale && i < shownUiLines.size() && shownUiLines[i] == uiLines[i]) continue;
+        out.moveTo(screenRows + 1 + static_cast<int>(i), 1);
+        out.append(uiLines[i]);
+        out.append("\033[K");
+        out.resetPen();
+    }
+    // Lines that went away (the HUD was switched off) are cleared
+    for (size_t i = uiLines.size(); i < shownUiLines.size(); i++) {
+        out.moveTo(screenRows + 1 + static_cast<int>(i), 1);
+        out.append("\033[K");
+    }
+    // The swap keeps both sets of strings, so neither allocates next frame
+    shownUiLines.swap(uiLines);
+    uiStale = false;
+}
 
-    // Output the complete buffer at once
-    std::cout << screenBuffer.str();
-    std::cout.flush();
+void GameRenderer::damage(int row, int col, int rows, int cols) {
+    if (col + cols - 1 > cellColumns * frameWidth) {
+        // Reaches past the maze's right edge, where nothing is tracked
+        invalidate();
+        return;
+    }
+    const int firstCell = (col - 1) / cellColumns;
+    const int lastCell = (col + cols - 2) / cellColumns;
+    for (int r = row; r < row + rows; r++) {
+        if (r > screenRows) {
+            // Over the UI lines
+            uiStale = true;
+            break;
+        }
+        Cell* cells = &frontCells[static_cast<size_t>(r - 1) * frameWidth];
+        for (int x = firstCell; x <= lastCell; x++) cells[x].color = CELL_UNKNOWN;
+    }
 }
 
 /**
@@ -129,6 +563,7 @@ void GameRenderer::renderGame(const GameManager& game) {
 
     // Full clear when switching to menu
     menuBuffer << "\033[2J\033[H";  // Clear screen and move cursor to top-left
+    invalidate();
     menuBuffer << resetColor() << "\n\n\n";
 
     // Title - centered
@@ -141,24 +576,24 @@ void GameRenderer::renderGame(const GameManager& game) {
     
     // Menu items
     for (int i = 1; i <= 5; i++) {
-        std::string prefix = (i == selectedDifficulty) ? colorSelected() + "→ " : colorText() + "  ";
-        std::string itemColor = (i == selectedDifficulty) ? colorSelected() : colorText();
+        std::string_view itemColor = (i == selectedDifficulty) ? colorSelected() : colorText();
+        std::string_view marker = (i == selectedDifficulty) ? "→ " : "  ";
         menuBuffer << std::setw(40) << "";
         switch (i) {
             case 1:
-                menuBuffer << prefix << itemColor << "1. Easy" << resetColor() << "\n";
+                menuBuffer << itemColor << marker << itemColor << "1. Easy" << resetColor() << "\n";
                 break;
             case 2:
-                menuBuffer << prefix << itemColor << "2. Medium" << resetColor() << "\n";
+                menuBuffer << itemColor << marker << itemColor << "2. Medium" << resetColor() << "\n";
                 break;
             case 3:
-                menuBuffer << prefix << itemColor << "3. Hard" << resetColor() << "\n";
+                menuBuffer << itemColor << marker << itemColor << "3. Hard" << resetColor() << "\n";
                 break;
             case 4:
-                menuBuffer << prefix << itemColor << "4. Continue Saved Game" << resetColor() << "\n";
+                menuBuffer << itemColor << marker << itemColor << "4. Continue Saved Game" << resetColor() << "\n";
                 break;
             case 5:
-                menuBuffer << prefix << itemColor << "Q. Quit" << resetColor() << "\n";
+                menuBuffer << itemColor << marker << itemColor << "Q. Quit" << resetColor() << "\n";
                 break;
         }
         menuBuffer << "\n";
@@ -172,68 +607,113 @@ void GameRenderer::renderGame(const GameManager& game) {
 }
 
 /**
- * Draw UI with health and controls (without box border).
+ * Lay out the UI lines under the maze: health, chest effect and controls,
+ * after one blank line, plus the debug HUD when enabled.
  */
-void GameRenderer::drawUI(const GameManager& game, std::ostringstream& buffer) {
+void GameRenderer::drawUI(const GameManager& game, std::vector<std::string>& lines) {
+    // Lines are rebuilt in place, in strings that keep their capacity
+    lines.resize(debugHud ? 5 : 4);
+    for (std::string& line : lines) line.clear();
     const Player* player = game.getPlayer();
     if (!player) return;
 
     // Health info
     int health = player->getHealth();
     int maxHealth = player->getMaxHealth();
-    std::string healthColor = (health == maxHealth) ? colorHealthGood() :
-                              (health > maxHealth / 2) ? colorHealthMedium() : colorHealthLow();
+    std::string_view healthColor = (health == maxHealth) ? colorHealthGood() :
+                                   (health > maxHealth / 2) ? colorHealthMedium() : colorHealthLow();
 
-    buffer << "\n";
-    buffer << colorText() << "Health: " << healthColor << health << "/" << maxHealth << resetColor() << "\n";
+    std::string& healthLine = lines[1];
+    healthLine.append(colorText()).append("Health: ").append(healthColor);
+    appendNumber(healthLine, health);
+    healthLine.append("/");
+    appendNumber(healthLine, maxHealth);
+    healthLine.append(resetColor());
 
     // Chest effect message - always reserve a line to prevent Controls from jumping
-    const std::string effectMessage = game.getActiveChestEffectMessage();
+    const std::string& effectMessage = game.getActiveChestEffectMessage();
     if (!effectMessage.empty()) {
-        buffer << colorText() << "Effect: " << colorEffect() << effectMessage << resetColor() << "\n";
-    } else {
-        // Reserve empty line when no effect message to keep Controls in fixed position
-        buffer << "\n";
+        lines[2].append(colorText()).append("Effect: ").append(colorEffect()).append(effectMessage).append(resetColor());
     }
 
     // Controls info - always on third line
-    buffer << colorText() << "Controls: Arrow Keys: Move | P: Pause | S: Save | M: Mark | R: Return | ESC: Menu" << resetColor() << "\n";
+    lines[3].append(colorText())
+            .append("Controls: Arrow Keys: Move | P: Pause | S: Save | M: Mark | R: Return | H: Hint | ESC: Menu")
+            .append(resetColor());
+
+    // Debug HUD: what the previous frame cost
+    if (debugHud) {
+        std::string& hud = lines[4];
+        hud.append(colorText()).append("Frame: ");
+        appendNumber(hud, static_cast<long>(lastFrame.bytes));
+        hud.append(" bytes, ");
+        appendNumber(hud, static_cast<long>(lastFrame.changedCells));
+        hud.append(" cells in ");
+        appendNumber(hud, static_cast<long>(lastFrame.runs));
+        hud.append(" runs, encoded in ");
+        appendNumber(hud, static_cast<long>(lastFrame.encodeUs));
+        hud.append(" us").append(lastFrame.full ? " (full)" : "").append(" | full redraws: ");
+        appendNumber(hud, fullRedraws);
+        hud.append(" | view ");
+        appendNumber(hud, viewWidth);
+        hud.append("x");
+        appendNumber(hud, viewHeight);
+        hud.append(" at ");
+        appendNumber(hud, viewX);
+        hud.append(",");
+        appendNumber(hud, viewY);
+        hud.append(resetColor());
+    }
 }
 
 /**
  * Draw pause overlay.
  */
-void GameRenderer::drawPauseOverlay(std::ostringstream& buffer) {
-    int overlayY = 10;
-    int overlayX = 40;
-    buffer << "\033[" << overlayY << ";" << overlayX << "H";
-    buffer << colorPaused() << "╔════════════════╗\n";
-    buffer << "\033[" << (overlayY + 1) << ";" << overlayX << "H" << colorPaused() << "║                ║\n";
-    buffer << "\033[" << (overlayY + 2) << ";" << overlayX << "H" << colorPaused() << "║    PAUSED      ║\n";
-    buffer << "\033[" << (overlayY + 3) << ";" << overlayX << "H" << colorPaused() << "║                ║\n";
-    buffer << "\033[" << (overlayY + 4) << ";" << overlayX << "H" << colorPaused() << "║ Press P to     ║\n";
-    buffer << "\033[" << (overlayY + 5) << ";" << overlayX << "H" << colorPaused() << "║ resume         ║\n";
-    buffer << "\033[" << (overlayY + 6) << ";" << overlayX << "H" << colorPaused() << "╚════════════════╝" << resetColor();
+void GameRenderer::drawPauseOverlay(FrameEncoder& out) {
+    // Centered on the view
+    const int viewRows = mode == RENDER_HALF ? (viewHeight + 3) / 2 : viewHeight + 2;
+    const int overlayY = 1 + std::max(0, (viewRows - 7) / 2);
+    const int overlayX = 1 + std::max(0, (cellColumns * (viewWidth + 2) - 18) / 2);
+    const std::string_view box[] = {
+        "╔════════════════╗",
+        "║                ║",
+        "║    PAUSED      ║",
+        "║                ║",
+        "║ Press P to     ║",
+        "║ resume         ║",
+        "╚════════════════╝",
+    };
+    out.append(colorPaused());
+    for (int i = 0; i < 7; i++) {
+        out.moveTo(overlayY + i, overlayX);
+        out.append(box[i]);
+    }
+    out.append(resetColor());
+    out.resetPen();
+    damage(overlayY, overlayX, 7, 18);
 }
 
 /**
  * Draw game over overlay.
  */
-void GameRenderer::drawGameOver(const GameManager& game, std::ostringstream& buffer) {
-    int overlayY = 10;
-    int overlayX = 35;
-    buffer << "\033[" << overlayY << ";" << overlayX << "H";
-    if (game.isGameWon()) {
-        buffer << colorWin() << "╔════════════════════════╗\n";
-        buffer << "\033[" << (overlayY + 1) << ";" << overlayX << "H" << colorWin() << "║                        ║\n";
-        buffer << "\033[" << (overlayY + 2) << ";" << overlayX << "H" << colorWin() << "║       YOU WIN!         ║\n";
-        buffer << "\033[" << (overlayY + 3) << ";" << overlayX << "H" << colorWin() << "║                        ║\n";
-        buffer << "\033[" << (overlayY + 4) << ";" << overlayX << "H" << colorWin() << "╚════════════════════════╝" << resetColor();
-    } else {
-        buffer << colorLose() << "╔════════════════════════╗\n";
-        buffer << "\033[" << (overlayY + 1) << ";" << overlayX << "H" << colorLose() << "║                        ║\n";
-        buffer << "\033[" << (overlayY + 2) << ";" << overlayX << "H" << colorLose() << "║      GAME OVER!        ║\n";
-        buffer << "\033[" << (overlayY + 3) << ";" << overlayX << "H" << colorLose() << "║                        ║\n";
-        buffer << "\033[" << (overlayY + 4) << ";" << overlayX << "H" << colorLose() << "╚════════════════════════╝" << resetColor();
+void GameRenderer::drawGameOver(const GameManager& game, FrameEncoder& out) {
+    // Centered on the view
+    const int viewRows = mode == RENDER_HALF ? (viewHeight + 3) / 2 : viewHeight + 2;
+    const int overlayY = 1 + std::max(0, (viewRows - 5) / 2);
+    const int overlayX = 1 + std::max(0, (cellColumns * (viewWidth + 2) - 26) / 2);
+    const std::string_view box[] = {
+        "╔════════════════════════╗",
+        "║                        ║",
+        game.isGameWon() ? "║       YOU WIN!         ║" : "║      GAME OVER!        ║",
+        "║                        ║",
+        "╚════════════════════════╝",
+    };
+    out.append(game.isGameWon() ? colorWin() : colorLose());
+    for (int i = 0; i < 5; i++) {
+        out.moveTo(overlayY + i, overlayX);
+        out.append(box[i]);
     }
+    out.append(resetColor());
+    out.resetPen();
+    damage(overlayY, overlayX, 5, 26);
 }
@@ -1,13 +1,30 @@
 #ifndef GAMERENDERER_H
 #define GAMERENDERER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
+#include "frame_encoder.h"
+#include "maze_pyramid.h"
+#include "terminal_size.h"
 
 // Forward declarations
 class GameManager;
 
+// How maze cells become terminal characters
+enum RenderMode {
+    RENDER_BLOCKS,      // two columns per cell ("██"), 256 colors
+    RENDER_HALF,        // one column per cell and two cells per row: "▀" in fg/bg colors
+    RENDER_ASCII        // one column per cell, plain ASCII glyphs, 16 colors
+};
+
+const char* renderModeName(RenderMode mode);
+// Parses "blocks", "half" or "ascii"
+bool renderModeFromName(const std::string& name, RenderMode& mode);
+
 class GameRenderer {
 public:
     GameRenderer();
@@ -19,39 +36,147 @@ public:
     void renderMenu(int selectedDifficulty);
     void renderPauseOverlay();
     void renderGameOver(const GameManager& game);
+    // Forget what is on screen; the next frame is drawn in full. Call after
+    // anything else has written to the terminal.
+    void invalidate();
+    // Adds a line under the controls with the size of the last frame
+    void setDebugHud(bool enabled) { debugHud = enabled; }
+    // Where frames are written (standard output by default)
+    void setOutputFd(int fd) { outputFd = fd; }
+    // Bytes of the last frame written; empty if nothing changed
+    std::string_view getLastFrame() const { return encoder.view(); }
+    // Lay frames out for a cols x rows screen instead of asking the
+    // terminal; 0 x 0 goes back to asking. Without a known size the whole
+    // maze is drawn.
+    void setScreenSize(int cols, int rows);
+    // When the maze does not fit on screen, show a downsampled map of all
+    // of it to the right of the view
+    void setMinimap(bool enabled) { minimap = enabled; }
+    void setRenderMode(RenderMode newMode);
+    RenderMode getRenderMode() const { return mode; }
+
+    struct FrameStats {
+        size_t bytes = 0;           // written to the terminal
+        size_t changedCells = 0;
+        size_t runs = 0;            // cursor jumps in the diff pass
+        bool full = false;
+        double encodeUs = 0.0;      // diffing and encoding, after the cells are built
+    };
+    const FrameStats& getLastFrameStats() const { return lastFrame; }
+    long getFullRedraws() const { return fullRedraws; }
+    // The part of the maze on screen, in maze cells
+    int getViewX() const { return viewX; }
+    int getViewY() const { return viewY; }
+    int getViewWidth() const { return viewWidth; }
+    int getViewHeight() const { return viewHeight; }
     
 private:
+    // Color of a screen cell, an index into the cell palette
+    enum CellColor : std::uint8_t {
+        CELL_WALL,
+        CELL_PATH,
+        CELL_PLAYER,
+        CELL_PLAYER_SHIELD,
+        CELL_GHOST,
+        CELL_CHEST,
+        CELL_EXIT,
+        CELL_SPAWNPOINT,
+        CELL_HINT,
+        CELL_MINIMAP,
+        CELL_MINIMAP_VIEW,      // minimap blocks inside the view
+        CELL_BLANK,             // terminal default, where nothing is drawn
+        CELL_UNKNOWN = 0xFF     // front buffer only: must be redrawn
+    };
+    // One tile of the frame: a maze cell, border piece or minimap block.
+    // The glyph is a single character standing for what is drawn ('#' is
+    // "██" in block mode). In half-block mode the screen cells are pairs
+    // of tiles instead, holding the upper and lower tile's 256-color index
+    // in glyph and color.
+    struct Cell {
+        char glyph;
+        std::uint8_t color;
+        bool operator==(const Cell& other) const { return glyph == other.glyph && color == other.color; }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+
     void drawMaze(const GameManager& game, std::vector<std::string>& buffer);
     void drawPlayer(const GameManager& game, std::vector<std::string>& buffer);
     void drawGhosts(const GameManager& game, std::vector<std::string>& buffer);
     void drawChests(const GameManager& game, std::vector<std::string>& buffer);
     void drawExit(const GameManager& game, std::vector<std::string>& buffer);
     void drawSpawnpoint(const GameManager& game, std::vector<std::string>& buffer);
-    void drawUI(const GameManager& game, std::ostringstream& buffer);
+    void drawUI(const GameManager& game, std::vector<std::string>& lines);
     void drawBorder(std::vector<std::string>& buffer);
-    void drawPauseOverlay(std::ostringstream& buffer);
-    void drawGameOver(const GameManager& game, std::ostringstream& buffer);
+    void drawPauseOverlay(FrameEncoder& out);
+    void drawGameOver(const GameManager& game, FrameEncoder& out);
+
+    // Screen size, view and minimap size for this frame; false if the
+    // frame's dimensions changed
+    bool layoutFrame(const GameManager& game);
+    // Moves the view when the player nears its edge
+    void followPlayer(const GameManager& game);
+    // Fills the tile buffer: the maze cells in view, a one-tile border and
+    // the minimap
+    void buildFrame(const GameManager& game);
+    void buildMinimap(const GameManager& game);
+    // The screen cells for the mode: the tiles themselves, or in half-block
+    // mode the tiles paired up by rows
+    const std::vector<Cell>& composeScreen();
+    // Appends the runs of screen cells that differ from the front buffer
+    // and copies them to it
+    void diffFrame(FrameEncoder& out, const std::vector<Cell>& back);
+    void encodeCell(FrameEncoder& out, const Cell& cell);
+    void diffUI(FrameEncoder& out);
+    // The screen area (1-based row/column) was drawn over; its cells are
+    // redrawn next frame
+    void damage(int row, int col, int rows, int cols);
+
+    RenderMode mode;
+    int cellColumns;                    // terminal columns per screen cell
+    int frameWidth, frameHeight;        // in tiles, border included
+    int screenRows;                     // rows of screen cells
+    std::vector<Cell> backCells;        // tiles
+    std::vector<Cell> halfCells;        // screen cells in half-block mode
+    std::vector<Cell> frontCells;       // screen cells as last written
+    std::vector<std::string> uiLines, shownUiLines;
+    FrameEncoder encoder;
+    int outputFd;
+    bool fullRedraw;
+    bool uiStale;               // rewrite every UI line next frame
+    bool debugHud;
+    FrameStats lastFrame;
+    long fullRedraws;
+
+    // Screen and view. The view is the window of maze cells drawn, at
+    // (viewX, viewY) in the maze; it recenters on the player when the
+    // player comes within a quarter of its size from an edge.
+    TerminalSize screen;
+    bool screenKnown;
+    bool fixedScreen;
+    int viewX, viewY, viewWidth, viewHeight;
+    std::uint32_t viewMazeVersion;
+    bool viewPlaced;
+
+    // Minimap: one level of a pyramid cached per maze
+    bool minimap;
+    MazePyramid pyramid;
+    std::uint32_t pyramidMazeVersion;
+    int minimapLevel, minimapWidth, minimapHeight;     // 0 x 0 when not shown
     
-    // Color codes (ANSI)
-    std::string resetColor() const { return "\033[0m"; }
-    std::string colorWall() const { return "\033[48;5;235m\033[38;5;240m"; }     // Dark gray background
-    std::string colorPath() const { return "\033[48;5;233m\033[38;5;248m"; }     // Dark background
-    std::string colorPlayer() const { return "\033[1;32m"; }                     // Bright green
-    std::string colorPlayerShield() const { return "\033[1;36m"; }               // Bright cyan
-    std::string colorGhost() const { return "\033[1;31m"; }                      // Bright red
-    std::string colorChest() const { return "\033[1;33m"; }                      // Bright yellow
-    std::string colorExit() const { return "\033[1;34m"; }                       // Bright blue
-    std::string colorSpawnpoint() const { return "\033[1;35m"; }                 // Bright magenta
-    std::string colorText() const { return "\033[1;37m"; }                       // Bright white
-    std::string colorHealthGood() const { return "\033[1;32m"; }                 // Green
-    std::string colorHealthMedium() const { return "\033[1;33m"; }               // Yellow
-    std::string colorHealthLow() const { return "\033[1;31m"; }                  // Red
-    std::string colorEffect() const { return "\033[1;36m"; }                     // Cyan
-    std::string colorTitle() const { return "\033[1;35m"; }                      // Magenta
-    std::string colorSelected() const { return "\033[1;33m"; }                   // Yellow
-    std::string colorPaused() const { return "\033[1;33m"; }                     // Yellow
-    std::string colorWin() const { return "\033[1;32m"; }                        // Green
-    std::string colorLose() const { return "\033[1;31m"; }                       // Red
+    // Color codes (ANSI) for the menu, UI lines and overlays; maze cells use
+    // the palette in GameRenderer.cpp. Literals, so using one never allocates.
+    std::string_view resetColor() const { return "\033[0m"; }
+    std::string_view colorText() const { return "\033[1;37m"; }           // Bright white
+    std::string_view colorHealthGood() const { return "\033[1;32m"; }     // Green
+    std::string_view colorHealthMedium() const { return "\033[1;33m"; }   // Yellow
+    std::string_view colorHealthLow() const { return "\033[1;31m"; }      // Red
+    std::string_view colorEffect() const { return "\033[1;36m"; }         // Cyan
+    std::string_view colorTitle() const { return "\033[1;35m"; }          // Magenta
+    std::string_view colorSelected() const { return "\033[1;33m"; }       // Yellow
+    std::string_view colorPaused() const { return "\033[1;33m"; }         // Yellow
+    std::string_view colorWin() const { return "\033[1;32m"; }            // Green
+    std::string_view colorLose() const { return "\033[1;31m"; }           // Red
 };
 
 #endif // GAMERENDERER_H
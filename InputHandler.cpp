@@ -53,6 +53,7 @@ KeyCode InputHandler::getNonBlockingKey() {
         case 'p': case 'P': return KEY_P;
         case 's': case 'S': return KEY_S;
         case 'm': case 'M': return KEY_M;
+        case 'h': case 'H': return KEY_H;
         case 'r': case 'R': return KEY_R;
         case 'q': case 'Q': return KEY_Q;
         case '1': return KEY_1;
@@ -155,6 +156,7 @@ KeyCode InputHandler::getNonBlockingKey() {
             case 'p': case 'P': return KEY_P;
             case 's': case 'S': return KEY_S;
             case 'm': case 'M': return KEY_M;
+            case 'h': case 'H': return KEY_H;
             case 'r': case 'R': return KEY_R;
             case 'q': case 'Q': return KEY_Q;
             case '1': return KEY_1;
@@ -27,7 +27,8 @@ enum KeyCode {
     KEY_7,
     KEY_8,
     KEY_9,
-    KEY_0
+    KEY_0,
+    KEY_H
 };
 
 class InputHandler {
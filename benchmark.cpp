@@ -0,0 +1,1737 @@
+// benchmark.cpp
+// Standalone timing harness for the maze engine. Build and run with `make bench`,
+// or pass section names to ./maze_bench to run only those sections:
+// grid, algorithms, large, tiled, stream, openareas, bitboard, hunters,
+// occupancy, walkable, swarm, ghostthreads, allocs, scheduler, lod,
+// corridors, hpa, pool, render, viewport, entities, modes. Exits non-zero
+// if the hunters, ghostthreads, allocs, lod, corridors, hpa, render,
+// viewport or modes check fails.
+#include "GameManager.h"
+#include "GameRenderer.h"
+#include "maze_generate.h"
+#include "maze_algorithms.h"
+#include "maze_stream.h"
+#include "fileio.h"
+#include "level_pool.h"
+#include "maze_postprocess.h"
+#include "maze_bitboard.h"
+#include "maze_tiled.h"
+#include "thread_pool.h"
+#include "maze_grid.h"
+#include "ghost.h"
+#include "flow_field.h"
+#include "walkable_index.h"
+#include "corridor_graph.h"
+#include "hpa_pathfinder.h"
+#include "maze_pyramid.h"
+#include "chest_generate.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <new>
+#include <random>
+#include <vector>
+
+// Every heap allocation in the process, for the steady-state allocation check
+static std::atomic<long> gAllocations(0);
+
+// Out of line so GCC does not pair the inlined free() with a new-expression
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Stops the optimiser from hoisting pure kernels out of timing loops
+template <typename T>
+void clobber(T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Swallows everything written to it, only counting the bytes
+class NullBuffer : public std::streambuf {
+public:
+    size_t bytes = 0;
+protected:
+    int overflow(int c) override { ++bytes; return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        bytes += static_cast<size_t>(n);
+        return n;
+    }
+};
+
+struct MazeSize {
+    const char* label;
+    int width;
+    int height;
+};
+
+const MazeSize kSizes[] = {
+    {"Hard 71x41", 71, 41},
+    {"501x501", 501, 501},
+    {"2001x2001", 2001, 2001},
+};
+
+const MazeSize kLargeSizes[] = {
+    {"1001x1001", 1001, 1001},
+    {"4001x4001", 4001, 4001},
+    {"10001x10001", 10001, 10001},
+};
+
+long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+    return usage.ru_maxrss;         // kilobytes on Linux
+#endif
+}
+
+// Counts open cells that have all four neighbours open, the access pattern
+// of the post-processing passes and ghost neighbour scans.
+__attribute__((noinline)) long scanFlat(const MazeGrid& maze) {
+    long count = 0;
+    for (int y = 1; y < maze.getHeight() - 1; ++y) {
+        for (int x = 1; x < maze.getWidth() - 1; ++x) {
+            if (maze(x, y) != '#' && maze(x - 1, y) != '#' && maze(x + 1, y) != '#' &&
+                maze(x, y - 1) != '#' && maze(x, y + 1) != '#') ++count;
+        }
+    }
+    return count;
+}
+
+__attribute__((noinline)) long scanNested(const std::vector<std::vector<char>>& maze) {
+    long count = 0;
+    int h = (int)maze.size(), w = (int)maze[0].size();
+    for (int y = 1; y < h - 1; ++y) {
+        for (int x = 1; x < w - 1; ++x) {
+            if (maze[y][x] != '#' && maze[y][x - 1] != '#' && maze[y][x + 1] != '#' &&
+                maze[y - 1][x] != '#' && maze[y + 1][x] != '#') ++count;
+        }
+    }
+    return count;
+}
+
+void benchGrid(const MazeSize& size) {
+    MazeGenerator gen;
+    gen.setDifficulty(3);
+    gen.setDimensions(size.width, size.height);
+
+    const int genRuns = size.width * size.height > 1000000 ? 1 : 5;
+    auto start = Clock::now();
+    for (int i = 0; i < genRuns; ++i) gen.generate();
+    double genMs = elapsedMs(start) / genRuns;
+
+    const MazeGrid& maze = gen.getMaze();
+    std::vector<std::vector<char>> nested(maze.getHeight());
+    for (int y = 0; y < maze.getHeight(); ++y) {
+        nested[y].assign(maze.row(y), maze.row(y) + maze.getWidth());
+    }
+    const int scanRuns = 20;
+    long sink = 0;
+    start = Clock::now();
+    for (int i = 0; i < scanRuns; ++i) { clobber(maze); sink += scanFlat(maze); }
+    double flatMs = elapsedMs(start) / scanRuns;
+    start = Clock::now();
+    for (int i = 0; i < scanRuns; ++i) { clobber(nested); sink += scanNested(nested); }
+    double nestedMs = elapsedMs(start) / scanRuns;
+
+    GhostManager ghosts(3);
+    ghosts.initializeGhosts(maze.getWidth(), maze.getHeight(), maze);
+    Position player(gen.getStartX(), gen.getStartY());
+    const int ticks = std::max(50, std::min(10000, 20000000 / (size.width * size.height)));
+    start = Clock::now();
+    for (int i = 0; i < ticks; ++i) ghosts.updateAllGhosts(player, maze);
+    double tickUs = elapsedMs(start) * 1000.0 / ticks;
+
+    std::cout << std::left << std::setw(12) << size.label << std::right << std::fixed
+              << std::setprecision(3)
+              << "  generate " << std::setw(10) << genMs << " ms"
+              << "  scan flat " << std::setw(8) << flatMs * 1000.0 << " us"
+              << "  scan nested " << std::setw(8) << nestedMs * 1000.0 << " us"
+              << "  ghost tick " << std::setw(8) << tickUs << " us"
+              << (sink < 0 ? " " : "") << "\n";
+}
+
+void benchAlgorithms() {
+    const MazeAlgorithmType algorithms[] = {ALGO_BACKTRACKER, ALGO_KRUSKAL, ALGO_WILSON,
+                                            ALGO_ELLER, ALGO_GROWING_TREE};
+    const MazeSize sizes[] = {{"Hard 71x41", 71, 41}, {"1001x1001", 1001, 1001},
+                              {"4001x4001", 4001, 4001}};
+    for (const MazeSize& size : sizes) {
+        for (MazeAlgorithmType type : algorithms) {
+            MazeGenerator gen;
+            gen.setDifficulty(3);
+            gen.setDimensions(size.width, size.height);
+            gen.setAlgorithm(type);
+            auto start = Clock::now();
+            gen.generate();
+            double genMs = elapsedMs(start);
+            const MazeCarveStats& stats = gen.getCarveStats();
+            std::cout << std::left << std::setw(12) << size.label << "  " << std::setw(13)
+                      << mazeAlgorithmName(type) << std::right << std::fixed << std::setprecision(2)
+                      << "  carve " << std::setw(8) << stats.cellsPerSecond() / 1e6 << " Mcells/s"
+                      << "  generate " << std::setw(9) << genMs << " ms"
+                      << "  aux " << std::setw(8) << stats.peakAuxBytes / 1024 << " KB\n";
+        }
+    }
+}
+
+// Runs body in a forked child so its peak RSS is measured in isolation
+void runIsolated(const std::function<void()>& body) {
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) return;
+    if (pid == 0) {
+        body();
+        std::cout.flush();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+void benchLargeGenerate(const MazeSize& size) {
+    runIsolated([&size]() {
+        MazeGenerator gen;
+        gen.setDifficulty(3);
+        gen.setDimensions(size.width, size.height);
+        auto start = Clock::now();
+        gen.generate();
+        double genMs = elapsedMs(start);
+        size_t stackBytes = gen.getCarveStats().peakAuxBytes;
+        std::cout << std::left << std::setw(12) << size.label << std::right << std::fixed
+                  << std::setprecision(1)
+                  << "  generate " << std::setw(10) << genMs << " ms"
+                  << "  carve stack peak " << std::setw(8) << stackBytes / 1024 << " KB"
+                  << "  peak RSS " << std::setw(8) << peakRssKb() << " KB\n";
+    });
+}
+
+// Tiled carving with 1..N threads against the plain single-threaded carve.
+// A perfect maze on cw x ch carving cells opens exactly 2 * cw * ch - 1 cells;
+// the grid must also be identical for every thread count.
+void benchTiled(const MazeSize& size, MazeAlgorithmType type, int tiles) {
+    const int cw = (size.width - 1) / 2, ch = (size.height - 1) / 2;
+    const size_t perfectOpen = 2 * static_cast<size_t>(cw) * ch - 1;
+    auto openCells = [](const MazeGrid& maze) {
+        return static_cast<size_t>(std::count(maze.data(), maze.data() + maze.cellCount(), ' '));
+    };
+
+    MazeGrid plain(size.width, size.height);
+    std::mt19937 plainGen(21);
+    auto start = Clock::now();
+    createMazeAlgorithm(type)->run(plain, 1, 1, plainGen);
+    double plainMs = elapsedMs(start);
+    std::cout << std::left << std::setw(12) << size.label << " " << std::setw(12)
+              << mazeAlgorithmName(type) << std::right << std::fixed << std::setprecision(1)
+              << "  untiled " << std::setw(8) << plainMs << " ms"
+              << (openCells(plain) == perfectOpen ? "" : "  NOT PERFECT") << "\n";
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    MazeGrid reference;
+    double oneThreadMs = 0.0;
+    for (unsigned threads = 1; threads <= cores; threads *= 2) {
+        ThreadPool pool(static_cast<int>(threads));
+        TiledMazeAlgorithm tiled(type, tiles, pool);
+        MazeGrid maze(size.width, size.height);
+        std::mt19937 gen(21);
+        start = Clock::now();
+        tiled.run(maze, 1, 1, gen);
+        double ms = elapsedMs(start);
+        if (threads == 1) {
+            oneThreadMs = ms;
+            reference = maze;
+        }
+        bool same = std::equal(maze.data(), maze.data() + maze.cellCount(), reference.data());
+        std::cout << "  " << tiles << "x" << tiles << " tiles, " << std::setw(2) << threads << " thread(s) "
+                  << std::setw(8) << ms << " ms  speedup x" << std::setprecision(2)
+                  << oneThreadMs / ms << std::setprecision(1)
+                  << (openCells(maze) == perfectOpen ? "  perfect" : "  NOT PERFECT")
+                  << (same ? "" : "  DIFFERS FROM 1 THREAD") << "\n";
+        if (threads == cores) break;
+        if (threads * 2 > cores) threads = cores / 2;  // always finish on every core
+    }
+}
+
+// Streams a maze to disk with Eller's algorithm, then scans it back through
+// the memory-mapped loader without materialising it
+void benchStream(const MazeSize& size) {
+    const std::string file = "maze_bench_stream.tmp";
+    runIsolated([&size, &file]() {
+        std::mt19937 gen(12345);
+        std::string err;
+        auto start = Clock::now();
+        if (!streamMazeToFile(file, size.width, size.height, 1, gen, err)) {
+            std::cout << size.label << "  stream failed: " << err << "\n";
+            return;
+        }
+        double writeMs = elapsedMs(start);
+        long writeRss = peakRssKb();
+
+        start = Clock::now();
+        MappedMazeFile mapped;
+        if (!mapped.open(file, err)) {
+            std::cout << size.label << "  map failed: " << err << "\n";
+            return;
+        }
+        long open = 0;
+        const GameState& header = mapped.getHeader();
+        for (int y = 0; y < header.height; ++y) {
+            const char* row = mapped.row(y);
+            for (int x = 0; x < header.width; ++x) open += row[x] == ' ';
+        }
+        double readMs = elapsedMs(start);
+        double cells = static_cast<double>(size.width) * size.height;
+
+        std::cout << std::left << std::setw(12) << size.label << std::right << std::fixed
+                  << std::setprecision(1)
+                  << "  stream " << std::setw(9) << writeMs << " ms (" << std::setw(6)
+                  << cells / writeMs / 1000.0 << " Mcells/s, RSS " << writeRss << " KB)"
+                  << "  mapped scan " << std::setw(8) << readMs << " ms, "
+                  << open << " open cells\n";
+    });
+    std::remove(file.c_str());
+}
+
+// The original removeOpenAreas: rescan the whole grid after every sweep
+// that placed a wall, allocating a cell vector for each open block
+void legacyRemoveOpenAreas(MazeGrid& maze, int startX, int startY, int exitX, int exitY,
+                           std::mt19937& gen) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int y = 0; y < maze.getHeight() - 1; ++y) {
+            for (int x = 0; x < maze.getWidth() - 1; ++x) {
+                if (maze(x, y) == ' ' && maze(x + 1, y) == ' ' &&
+                    maze(x, y + 1) == ' ' && maze(x + 1, y + 1) == ' ') {
+                    std::vector<std::pair<int, int>> cells = {{x, y}, {x + 1, y}, {x, y + 1}, {x + 1, y + 1}};
+                    std::shuffle(cells.begin(), cells.end(), gen);
+                    for (auto& c : cells) {
+                        if ((c.first == startX && c.second == startY) ||
+                            (c.first == exitX && c.second == exitY)) continue;
+                        maze(c.first, c.second) = '#';
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Perfect maze with a share of its interior walls knocked out, so it is
+// full of open 2x2 blocks for the open-area passes to remove
+MazeGrid openAreaInput(int width, int height, int openPercent) {
+    MazeGrid maze(width, height);
+    std::mt19937 gen(7);
+    createMazeAlgorithm(ALGO_BACKTRACKER)->run(maze, 1, 1, gen);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (int y = 1; y < height - 1; ++y) {
+        for (int x = 1; x < width - 1; ++x) {
+            if (maze(x, y) == '#' && percent(gen) < openPercent) maze(x, y) = ' ';
+        }
+    }
+    return maze;
+}
+
+void benchRemoveOpenAreas() {
+    const MazeSize sizes[] = {{"Hard 71x41", 71, 41}, {"1001x1001", 1001, 1001},
+                              {"2001x2001", 2001, 2001}, {"4001x4001", 4001, 4001}};
+    for (const MazeSize& size : sizes) {
+        for (int openPercent : {5, 50}) {
+            MazeGrid input = openAreaInput(size.width, size.height, openPercent);
+            MazeGrid legacy = input, worklist = input;
+            std::mt19937 legacyGen(99), worklistGen(99);
+            int ex = size.width - 2, ey = size.height - 2;
+
+            auto start = Clock::now();
+            legacyRemoveOpenAreas(legacy, 1, 1, ex, ey, legacyGen);
+            double legacyMs = elapsedMs(start);
+            start = Clock::now();
+            removeOpenAreas(worklist, 1, 1, ex, ey, worklistGen);
+            double worklistMs = elapsedMs(start);
+
+            bool identical = std::equal(legacy.data(), legacy.data() + legacy.cellCount(), worklist.data());
+            std::cout << std::left << std::setw(12) << size.label << std::right
+                      << "  " << std::setw(2) << openPercent << "% walls opened" << std::fixed
+                      << std::setprecision(2)
+                      << "  legacy " << std::setw(9) << legacyMs << " ms"
+                      << "  worklist " << std::setw(9) << worklistMs << " ms"
+                      << "  output " << (identical ? "identical" : "DIFFERENT") << "\n";
+        }
+    }
+}
+
+// Average ms of `reps` runs of pass, each on a fresh copy of input made by prepare
+template <typename Input, typename Prepare, typename Pass>
+double timePass(const Input& input, int reps, Prepare prepare, Pass pass) {
+    double totalMs = 0.0;
+    for (int i = 0; i < reps; ++i) {
+        auto work = prepare(input);
+        auto start = Clock::now();
+        pass(work);
+        totalMs += elapsedMs(start);
+        clobber(work);
+    }
+    return totalMs / reps;
+}
+
+// Each post-processing pass on MazeGrid versus MazeBitboard, from the same
+// input and RNG seed. Bitboard times exclude load/store, reported separately.
+void benchBitboard() {
+    const MazeSize sizes[] = {{"Easy 31x21", 31, 21}, {"Medium 51x31", 51, 31},
+                              {"Hard 71x41", 71, 41}, {"4001x4001", 4001, 4001}};
+    for (const MazeSize& size : sizes) {
+        const int reps = size.width * size.height > 100000 ? 3 : 2000;
+        const int ex = size.width - 2, ey = size.height - 2;
+
+        MazeGrid carved(size.width, size.height);
+        std::mt19937 carveGen(3);
+        createMazeAlgorithm(ALGO_WILSON)->run(carved, 1, 1, carveGen);
+        carved(ex, ey) = ' ';
+        MazeGrid blocky = openAreaInput(size.width, size.height, 50);
+
+        auto copyGrid = [](const MazeGrid& g) { return g; };
+        auto toBits = [](const MazeGrid& g) { return MazeBitboard(g); };
+
+        struct Row { const char* pass; double scalarMs, bitsMs; bool identical; };
+        std::vector<Row> rows;
+
+        {
+            MazeGrid a = carved; MazeBitboard b(carved); MazeGrid out = carved;
+            ensureReachable(a, 1, 1, ex, ey);
+            ensureReachable(b, 1, 1, ex, ey);
+            b.store(out);
+            rows.push_back({"ensureReachable",
+                timePass(carved, reps, copyGrid, [&](MazeGrid& g) { ensureReachable(g, 1, 1, ex, ey); }),
+                timePass(carved, reps, toBits, [&](MazeBitboard& g) { ensureReachable(g, 1, 1, ex, ey); }),
+                std::equal(a.data(), a.data() + a.cellCount(), out.data())});
+        }
+        {
+            MazeGrid a = carved; MazeBitboard b(carved); MazeGrid out = carved;
+            std::mt19937 ga(5), gb(5);
+            addExtraPassages(a, 3, ga);
+            addExtraPassages(b, 3, gb);
+            b.store(out);
+            rows.push_back({"addExtraPassages",
+                timePass(carved, reps, copyGrid, [&](MazeGrid& g) { std::mt19937 r(5); addExtraPassages(g, 3, r); }),
+                timePass(carved, reps, toBits, [&](MazeBitboard& g) { std::mt19937 r(5); addExtraPassages(g, 3, r); }),
+                std::equal(a.data(), a.data() + a.cellCount(), out.data())});
+        }
+        {
+            MazeGrid a = blocky; MazeBitboard b(blocky); MazeGrid out = blocky;
+            std::mt19937 ga(99), gb(99);
+            removeOpenAreas(a, 1, 1, ex, ey, ga);
+            removeOpenAreas(b, 1, 1, ex, ey, gb);
+            b.store(out);
+            rows.push_back({"removeOpenAreas",
+                timePass(blocky, reps, copyGrid, [&](MazeGrid& g) { std::mt19937 r(99); removeOpenAreas(g, 1, 1, ex, ey, r); }),
+                timePass(blocky, reps, toBits, [&](MazeBitboard& g) { std::mt19937 r(99); removeOpenAreas(g, 1, 1, ex, ey, r); }),
+                std::equal(a.data(), a.data() + a.cellCount(), out.data())});
+        }
+
+        MazeGrid storeTarget = carved;
+        double loadMs = timePass(carved, reps, copyGrid, [](MazeGrid& g) { MazeBitboard b(g); clobber(b); });
+        double storeMs = timePass(MazeBitboard(carved), reps, [](const MazeBitboard& b) { return b; },
+                                  [&](MazeBitboard& b) { b.store(storeTarget); });
+
+        std::cout << size.label << " (" << reps << " reps, load " << std::fixed << std::setprecision(4)
+                  << loadMs << " ms, store " << storeMs << " ms)\n";
+        for (const Row& row : rows) {
+            std::cout << "  " << std::left << std::setw(18) << row.pass << std::right
+                      << "  grid " << std::setw(10) << row.scalarMs << " ms"
+                      << "  bitboard " << std::setw(10) << row.bitsMs << " ms"
+                      << "  x" << std::setprecision(2) << std::setw(6)
+                      << (row.bitsMs > 0.0 ? row.scalarMs / row.bitsMs : 0.0) << std::setprecision(4)
+                      << "  output " << (row.identical ? "identical" : "DIFFERENT") << "\n";
+        }
+    }
+}
+
+// Braided Hard-style maze with every open cell listed, for ghost benchmarks
+MazeGrid hunterMaze(const MazeSize& size, std::vector<Position>& open) {
+    MazeGrid maze(size.width, size.height);
+    std::mt19937 gen(17);
+    createMazeAlgorithm(ALGO_BACKTRACKER)->run(maze, 1, 1, gen);
+    addExtraPassages(maze, 3, gen);
+    open.clear();
+    for (int y = 0; y < maze.getHeight(); ++y) {
+        for (int x = 0; x < maze.getWidth(); ++x) {
+            if (maze(x, y) != '#') open.emplace_back(x, y);
+        }
+    }
+    return maze;
+}
+
+// The pre-flow-field hunter: greedy on Manhattan distance, random otherwise
+Position manhattanHunterMove(Position at, Position player, const MazeGrid& maze, std::mt19937& gen) {
+    const int dx[4] = {-1, 1, 0, 0}, dy[4] = {0, 0, -1, 1};
+    Position options[4], best[4];
+    int optionCount = 0, bestCount = 0;
+    int bestDistance = std::abs(at.x - player.x) + std::abs(at.y - player.y);
+    for (int dir = 0; dir < 4; ++dir) {
+        Position next(at.x + dx[dir], at.y + dy[dir]);
+        if (!maze.inBounds(next.x, next.y) || maze(next.x, next.y) == '#') continue;
+        options[optionCount++] = next;
+        int d = std::abs(next.x - player.x) + std::abs(next.y - player.y);
+        if (d < bestDistance) { bestDistance = d; bestCount = 0; }
+        if (d == bestDistance) best[bestCount++] = next;
+    }
+    if (bestCount > 0) return best[std::uniform_int_distribution<>(0, bestCount - 1)(gen)];
+    if (optionCount == 0) return at;
+    return options[std::uniform_int_distribution<>(0, optionCount - 1)(gen)];
+}
+
+// Hunter ticks against a player on a random walk: the shared field is
+// updated once per tick whatever the hunter count, then every hunter does an
+// O(1) lookup. Also compares how many hunters actually reach a stationary
+// player with the field versus the old Manhattan heuristic, and checks that
+// a field updated only every few steps matches a fresh BFS.
+bool benchHunters() {
+    bool ok = true;
+    const MazeSize sizes[] = {{"1001x1001", 1001, 1001}, {"2001x2001", 2001, 2001}};
+    for (const MazeSize& size : sizes) {
+        std::vector<Position> open;
+        MazeGrid maze = hunterMaze(size, open);
+        std::mt19937 gen(23);
+        auto randomOpen = [&]() { return open[std::uniform_int_distribution<size_t>(0, open.size() - 1)(gen)]; };
+
+        FlowField field;
+        auto start = Clock::now();
+        const int builds = 5;
+        for (int i = 0; i < builds; ++i) field.build(maze, 1, 1);
+        double buildMs = elapsedMs(start) / builds;
+        std::cout << size.label << "  full BFS " << std::fixed << std::setprecision(3)
+                  << buildMs << " ms (" << field.getLastUpdateCells() << " cells)\n";
+
+        // One player step per tick, mostly to a neighbouring cell
+        const int ticks = 400;
+        std::vector<Position> walk;
+        Position player(1, 1);
+        std::mt19937 walkGen(7);
+        for (int t = 0; t < ticks; ++t) {
+            const int dx[4] = {-1, 1, 0, 0}, dy[4] = {0, 0, -1, 1};
+            int dir = static_cast<int>(walkGen() % 4);
+            if (maze(player.x + dx[dir], player.y + dy[dir]) != '#') {
+                player = Position(player.x + dx[dir], player.y + dy[dir]);
+            }
+            walk.push_back(player);
+        }
+
+        field.build(maze, 1, 1);
+        size_t relaxedCells = 0;
+        start = Clock::now();
+        for (const Position& p : walk) {
+            field.moveTarget(maze, p.x, p.y);
+            relaxedCells += field.getLastUpdateCells();
+        }
+        double fieldMs = elapsedMs(start) / ticks;
+        std::cout << "  incremental field update " << fieldMs << " ms/tick ("
+                  << relaxedCells / ticks << " cells)\n";
+
+        // Hunters wake every few ticks, so the target has moved several
+        // cells by the time the field is updated
+        const size_t lag = 8;
+        field.build(maze, 1, 1);
+        relaxedCells = 0;
+        start = Clock::now();
+        for (size_t t = lag - 1; t < walk.size(); t += lag) {
+            field.moveTarget(maze, walk[t].x, walk[t].y);
+            relaxedCells += field.getLastUpdateCells();
+        }
+        const double laggedMs = elapsedMs(start) / (walk.size() / lag);
+        FlowField fresh;
+        fresh.build(maze, walk.back().x, walk.back().y);
+        size_t wrong = 0;
+        for (const Position& p : open) {
+            if (field.distance(p.x, p.y) != fresh.distance(p.x, p.y)) ++wrong;
+        }
+        ok = ok && wrong == 0;
+        std::cout << "  update every " << lag << " steps   " << laggedMs << " ms/update ("
+                  << relaxedCells / (walk.size() / lag) << " cells), "
+                  << (wrong == 0 ? "matches a fresh BFS" : "DIFFERS FROM A FRESH BFS") << "\n";
+
+        const int counts[] = {1, 10, 1000};
+        for (int count : counts) {
+            GhostManager ghosts(1, 41);
+            for (int i = 0; i < count; ++i) ghosts.addGhost(maze, randomOpen(), HUNTER, 100);
+            ghosts.updateAllGhosts(Position(1, 1), maze); // initial full build
+            start = Clock::now();
+            for (const Position& p : walk) ghosts.updateAllGhosts(p, maze);
+            double tickMs = elapsedMs(start) / ticks;
+            // Parked player: no field work, only the per-hunter step
+            start = Clock::now();
+            for (int t = 0; t < ticks; ++t) ghosts.updateAllGhosts(walk.back(), maze);
+            double hunterNs = elapsedMs(start) * 1e6 / ticks / count;
+            std::cout << "  " << std::setw(5) << count << " hunters  tick " << std::setw(8) << tickMs
+                      << " ms, per hunter " << std::setw(8) << hunterNs << " ns\n";
+        }
+
+        // Navigation quality: hunters spread over the maze, player parked in
+        // the middle, no ghost-ghost blocking so only the steering differs
+        Position parked = open[open.size() / 2];
+        field.build(maze, parked.x, parked.y);
+        const int hunters = 200, steps = size.width * 2;
+        int reachedField = 0, reachedManhattan = 0;
+        std::mt19937 steer(3);
+        for (int i = 0; i < hunters; ++i) {
+            Position start = randomOpen();
+            Position a = start, b = start;
+            for (int t = 0; t < steps && a != parked; ++t) {
+                const int dx[4] = {-1, 1, 0, 0}, dy[4] = {0, 0, -1, 1};
+                for (int dir = 0; dir < 4; ++dir) {
+                    if (field.distance(a.x + dx[dir], a.y + dy[dir]) < field.distance(a.x, a.y)) {
+                        a = Position(a.x + dx[dir], a.y + dy[dir]);
+                        break;
+                    }
+                }
+            }
+            for (int t = 0; t < steps && b != parked; ++t) b = manhattanHunterMove(b, parked, maze, steer);
+            reachedField += a == parked;
+            reachedManhattan += b == parked;
+        }
+        std::cout << "  reach a parked player within " << steps << " steps: flow field "
+                  << reachedField << "/" << hunters << ", Manhattan " << reachedManhattan
+                  << "/" << hunters << "\n";
+    }
+    return ok;
+}
+
+// Ghost ticks with thousands of ghosts and chests. Move checks go through the
+// occupancy grid; the old per-move scans of the chest and ghost lists are
+// timed on their own for comparison (move checks only, no movement).
+void benchOccupancy() {
+    std::vector<Position> open;
+    MazeGrid maze = hunterMaze({"1001x1001", 1001, 1001}, open);
+    std::mt19937 gen(29);
+    std::shuffle(open.begin(), open.end(), gen);
+    const size_t chestCount = open.size() / 100;
+    std::vector<Position> chests(open.begin(), open.begin() + chestCount);
+
+    const int counts[] = {10, 100, 1000, 5000};
+    for (int count : counts) {
+        GhostManager ghosts(1, 43);
+        for (int i = 0; i < count; ++i) {
+            ghosts.addGhost(maze, open[chestCount + i], static_cast<GhostType>(i % 3), 100);
+        }
+        ghosts.setChests(chests);
+        ghosts.updateAllGhosts(Position(1, 1), maze); // hunters' field BFS
+        const int ticks = 200;
+        auto start = Clock::now();
+        for (int t = 0; t < ticks; ++t) ghosts.updateAllGhosts(Position(1, 1), maze);
+        double tickMs = elapsedMs(start) / ticks;
+
+        // Old check: every ghost tests one candidate against both lists
+        const std::vector<Position>& positions = ghosts.getPositions();
+        const int scanTicks = count > 1000 ? 2 : 20;
+        long blocked = 0;
+        start = Clock::now();
+        for (int t = 0; t < scanTicks; ++t) {
+            for (const Position& p : positions) {
+                Position next(p.x + 1, p.y);
+                bool hit = false;
+                for (const Position& c : chests) hit |= c == next;
+                for (const Position& g : positions) hit |= g == next;
+                blocked += hit;
+                clobber(blocked);
+            }
+        }
+        double scanMs = elapsedMs(start) / scanTicks;
+        std::cout << std::setw(5) << count << " ghosts, " << chestCount << " chests  tick "
+                  << std::fixed << std::setprecision(3) << std::setw(8) << tickMs << " ms ("
+                  << std::setw(7) << tickMs * 1e6 / count << " ns/ghost)  list scans alone "
+                  << std::setw(9) << scanMs << " ms\n";
+    }
+}
+
+// The shared free-cell index: one build per level, then O(1) draws for
+// teleports and spawns, against the full-maze scan each teleport used to do
+void benchWalkable() {
+    const MazeSize sizes[] = {{"Hard 71x41", 71, 41}, {"1001x1001", 1001, 1001},
+                              {"2001x2001", 2001, 2001}};
+    for (const MazeSize& size : sizes) {
+        std::vector<Position> open;
+        MazeGrid maze = hunterMaze(size, open);
+        const int reps = size.width * size.height > 100000 ? 5 : 2000;
+
+        auto start = Clock::now();
+        for (int i = 0; i < reps; ++i) { WalkableIndex index(maze); clobber(index); }
+        double buildMs = elapsedMs(start) / reps;
+
+        start = Clock::now();
+        for (int i = 0; i < reps; ++i) {
+            std::vector<Position> empty;
+            for (int y = 0; y < maze.getHeight(); ++y) {
+                for (int x = 0; x < maze.getWidth(); ++x) {
+                    if (maze(x, y) == ' ') empty.emplace_back(x, y);
+                }
+            }
+            clobber(empty);
+        }
+        double scanMs = elapsedMs(start) / reps;
+
+        WalkableIndex index(maze);
+        std::mt19937 gen(31);
+        const int draws = 1000000;
+        long sink = 0;
+        start = Clock::now();
+        for (int i = 0; i < draws; ++i) { sink += index.sample(gen).x; clobber(sink); }
+        double sampleNs = elapsedMs(start) * 1e6 / draws;
+
+        std::vector<std::uint32_t> path;
+        double chestMs = 0.0;
+        size_t chestCount = 0;
+        for (int i = 0; i < reps; ++i) {
+            WalkableIndex chestIndex = index;
+            std::mt19937 chestGen(i);
+            start = Clock::now();
+            chestCount = ChestGenerator::generateChests(maze, chestIndex, path, 1, 1,
+                                                        size.width - 2, size.height - 2, 3,
+                                                        chestGen).size();
+            chestMs += elapsedMs(start);
+        }
+        chestMs /= reps;
+
+        std::cout << std::left << std::setw(12) << size.label << std::right << std::fixed
+                  << std::setprecision(4) << "  index build " << std::setw(9) << buildMs << " ms"
+                  << "  teleport scan " << std::setw(9) << scanMs << " ms"
+                  << "  index draw " << std::setw(6) << std::setprecision(1) << sampleNs << " ns"
+                  << "  " << chestCount << " chests " << std::setprecision(4) << chestMs << " ms"
+                  << (sink < 0 ? " " : "") << "\n";
+    }
+}
+
+// Swarms of the Hard ghost mix on a large maze with a walking player. The
+// structure-of-arrays manager should keep ns per ghost per tick flat as the
+// count grows.
+void benchSwarm() {
+    std::vector<Position> open;
+    MazeGrid maze = hunterMaze({"2001x2001", 2001, 2001}, open);
+    const int counts[] = {1000, 10000, 100000};
+    for (int count : counts) {
+        GhostManager ghosts(3, 53);
+        auto start = Clock::now();
+        std::vector<Position> spawns = ghosts.planGhostSpawns(maze.getWidth(), maze.getHeight(), maze, count);
+        ghosts.initializeGhosts(maze, spawns);
+        double initMs = elapsedMs(start);
+
+        std::mt19937 walk(11);
+        Position player(1, 1);
+        ghosts.updateAllGhosts(player, maze); // hunters' first field build
+        const int ticks = 100;
+        start = Clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            int dir = static_cast<int>(walk() % 4);
+            Position next(player.x + NeighborMasks::kDx[dir], player.y + NeighborMasks::kDy[dir]);
+            if (maze(next.x, next.y) != '#') player = next;
+            ghosts.updateAllGhosts(player, maze);
+        }
+        double tickMs = elapsedMs(start) / ticks;
+        // Parked player: the shared hunter field costs nothing, leaving the
+        // per-ghost work
+        start = Clock::now();
+        for (int t = 0; t < ticks; ++t) ghosts.updateAllGhosts(player, maze);
+        double ghostNs = elapsedMs(start) * 1e6 / ticks / count;
+
+        std::cout << std::setw(6) << count << " ghosts  init " << std::fixed << std::setprecision(2)
+                  << std::setw(7) << initMs << " ms  tick with walking player " << std::setw(7) << tickMs
+                  << " ms  " << std::setw(6) << std::setprecision(1) << ghostNs << " ns/ghost/tick  "
+                  << static_cast<double>(ghosts.ghostMemoryBytes()) / count << " bytes/ghost\n";
+    }
+}
+
+// Multithreaded move pass: 100k Hard-mix ghosts ticked with 1-4 threads.
+// The final positions must hash the same for every thread count.
+bool benchGhostThreads() {
+    std::vector<Position> open;
+    MazeGrid maze = hunterMaze({"2001x2001", 2001, 2001}, open);
+    const int threadCounts[] = {1, 2, 4};
+    std::uint64_t firstHash = 0;
+    bool identical = true;
+    for (int threads : threadCounts) {
+        ThreadPool pool(threads);
+        GhostManager ghosts(3, 59);
+        ghosts.setThreadPool(&pool);
+        ghosts.initializeGhosts(maze, ghosts.planGhostSpawns(maze.getWidth(), maze.getHeight(), maze, 100000));
+        Position player(1, 1);
+        ghosts.updateAllGhosts(player, maze); // hunters' first field build
+
+        const int ticks = 100;
+        auto start = Clock::now();
+        for (int t = 0; t < ticks; ++t) ghosts.updateAllGhosts(player, maze);
+        double tickMs = elapsedMs(start) / ticks;
+
+        std::uint64_t hash = 1469598103934665603ull;
+        for (const Position& p : ghosts.getPositions()) {
+            hash = (hash ^ static_cast<std::uint64_t>(p.y * maze.getWidth() + p.x)) * 1099511628211ull;
+        }
+        if (threads == threadCounts[0]) firstHash = hash;
+        identical = identical && hash == firstHash;
+        std::cout << threads << " thread(s)  100000 ghosts  tick " << std::fixed << std::setprecision(2)
+                  << std::setw(7) << tickMs << " ms  positions hash " << std::hex << hash << std::dec
+                  << (hash == firstHash ? "" : "  (DIFFERENT)") << "\n";
+    }
+    return identical;
+}
+
+// Steady-state ghost ticks must not touch the heap: every ghost type, chests
+// on the floor and a player walking one cell per tick (incremental field
+// updates). Returns false if any tick allocated.
+bool benchAllocations(const MazeSize& size, int ghostCount, int threads) {
+    std::vector<Position> open;
+    MazeGrid maze = hunterMaze(size, open);
+    std::mt19937 gen(37);
+    std::shuffle(open.begin(), open.end(), gen);
+    ThreadPool pool(threads);
+    GhostManager ghosts(3, 47);
+    if (threads > 1) ghosts.setThreadPool(&pool);
+    for (int i = 0; i < ghostCount; ++i) ghosts.addGhost(maze, open[i], static_cast<GhostType>(i % 4), 100);
+    std::vector<Position> chests(open.begin() + ghostCount, open.begin() + 2 * ghostCount);
+    ghosts.setChests(chests);
+
+    Position player(1, 1);
+    auto step = [&]() {
+        int dir = static_cast<int>(gen() % 4);
+        Position next(player.x + NeighborMasks::kDx[dir], player.y + NeighborMasks::kDy[dir]);
+        if (maze(next.x, next.y) != '#') player = next;
+        ghosts.updateAllGhosts(player, maze);
+    };
+    for (int t = 0; t < 50; ++t) step(); // first field build and warm-up
+
+    const int ticks = 2000;
+    long before = gAllocations.load();
+    auto start = Clock::now();
+    for (int t = 0; t < ticks; ++t) step();
+    double tickUs = elapsedMs(start) * 1000.0 / ticks;
+    long allocations = gAllocations.load() - before;
+
+    std::cout << size.label << ", " << ghostCount << " ghosts, " << ghostCount << " chests, "
+              << threads << " thread(s): " << ticks << " ticks, " << std::fixed
+              << std::setprecision(2) << tickUs << " us/tick, " << allocations
+              << " heap allocations " << (allocations == 0 ? "(ok)" : "(FAIL)") << "\n";
+    return allocations == 0;
+}
+
+// Level of detail: Hard swarms on 2001x2001, every ghost exact versus
+// ghosts beyond two chunks at the coarse rate. Ghost work is timed with the
+// player standing at a series of spots across the maze (the hunters' flow
+// field is rebuilt in the first half second there, outside the timing, and
+// costs the same either way). A second run has the player walk through the maze; after it
+// no far ghost may be in range, the occupancy grid must match the ghost
+// positions, every ghost must be on an open cell and every guard on its
+// route, and the result must not depend on the thread count. Returns false
+// otherwise.
+bool benchLod() {
+    std::vector<Position> open;
+    MazeGrid maze = hunterMaze({"2001x2001", 2001, 2001}, open);
+    bool ok = true;
+
+    std::mt19937 gen(101);
+    std::vector<Position> stops;
+    for (int i = 0; i < 8; ++i) stops.push_back(open[std::uniform_int_distribution<size_t>(0, open.size() - 1)(gen)]);
+
+    // The walk prefers to keep its heading, so it crosses several chunks
+    const int frames = 400;
+    std::vector<Position> walkPath;
+    CompactRng walk = makeCompactRng(5, RNG_EVENTS, 0);
+    Position at(1, 1);
+    int heading = 1;
+    for (int f = 0; f < frames; ++f) {
+        for (int tries = 0; tries < 8 && f % 4 == 0; ++tries) {
+            Position next(at.x + NeighborMasks::kDx[heading], at.y + NeighborMasks::kDy[heading]);
+            if (maze.inBounds(next.x, next.y) && maze(next.x, next.y) != '#') {
+                at = next;
+                break;
+            }
+            heading = static_cast<int>(walk.below(4));
+        }
+        walkPath.push_back(at);
+    }
+
+    const int counts[] = {25000, 100000};
+    for (int count : counts) {
+        double frameUs[2] = {0.0, 0.0};
+        for (int radius : {0, 2}) {
+            GhostManager ghosts(3, 97);
+            ghosts.setLodRadius(radius);
+            ghosts.initializeGhosts(maze, ghosts.planGhostSpawns(maze.getWidth(), maze.getHeight(), maze, count));
+            const int framesPerStop = 25;
+            double timedMs = 0.0;
+            size_t near = 0, due = 0;
+            for (const Position& stop : stops) {
+                for (int f = 0; f < 5; ++f) ghosts.advanceTo(ghosts.getClockMs() + 100, stop, maze);
+                auto start = Clock::now();
+                for (int f = 0; f < framesPerStop; ++f) {
+                    ghosts.advanceTo(ghosts.getClockMs() + 100, stop, maze);
+                    due += ghosts.getLastDueCount();
+                }
+                timedMs += elapsedMs(start);
+                near += ghosts.getGhostCount() - ghosts.getFarGhostCount();
+            }
+            const size_t timedFrames = stops.size() * framesPerStop;
+            frameUs[radius > 0] = timedMs * 1000.0 / timedFrames;
+            std::cout << std::setw(6) << count << " ghosts, " << (radius ? "LOD radius 2" : "all exact   ") << ": "
+                      << std::fixed << std::setprecision(1) << std::setw(8) << frameUs[radius > 0] << " us/frame, "
+                      << std::setw(6) << near / stops.size() << " near, " << std::setw(6) << due / timedFrames
+                      << " woken/frame\n";
+        }
+        std::cout << "        " << std::setprecision(1) << frameUs[0] / frameUs[1] << "x less ghost work per frame\n";
+
+        std::uint64_t firstHash = 0;
+        for (int threads : {1, 2}) {
+            ThreadPool pool(threads);
+            GhostManager ghosts(3, 97);
+            ghosts.setThreadPool(&pool);
+            ghosts.setLodRadius(2);
+            ghosts.initializeGhosts(maze, ghosts.planGhostSpawns(maze.getWidth(), maze.getHeight(), maze, count));
+            for (const Position& player : walkPath) ghosts.advanceTo(ghosts.getClockMs() + 100, player, maze);
+
+            const Position& player = walkPath.back();
+            const int chunk = GhostManager::kLodChunkCells;
+            std::vector<int> onCell(maze.cellCount(), 0);
+            bool consistent = true;
+            for (int id = 0; id < ghosts.getGhostCount(); ++id) {
+                Position p = ghosts.getGhostPosition(id);
+                bool inRange = std::abs(p.x / chunk - player.x / chunk) <= 2 && std::abs(p.y / chunk - player.y / chunk) <= 2;
+                consistent = consistent && maze(p.x, p.y) != '#' && !(ghosts.isGhostFar(id) && inRange);
+                ++onCell[maze.index(p.x, p.y)];
+                if (ghosts.getGhostType(id) == PATROL_GUARD) {
+                    std::vector<Position> route = ghosts.getPatrolRoute(id);
+                    consistent = consistent && (route.empty() || std::find(route.begin(), route.end(), p) != route.end());
+                }
+            }
+            for (const Position& p : open) {
+                consistent = consistent && ghosts.getOccupancy().ghostCount(p.x, p.y) == onCell[maze.index(p.x, p.y)];
+            }
+            std::uint64_t hash = 1469598103934665603ull;
+            for (const Position& p : ghosts.getPositions()) {
+                hash = (hash ^ static_cast<std::uint64_t>(p.y * maze.getWidth() + p.x)) * 1099511628211ull;
+            }
+            if (threads == 1) firstHash = hash;
+            consistent = consistent && hash == firstHash;
+            ok = ok && consistent;
+            std::cout << "        walk, " << threads << " thread(s): " << ghosts.getFarGhostCount() << " far, hash "
+                      << std::hex << hash << std::dec << ", " << (consistent ? "consistent" : "INCONSISTENT") << "\n";
+        }
+    }
+    return ok;
+}
+
+// Ghosts on the timing wheel: 100k ghosts of every type, with the clock
+// advanced 100 ms per frame over 20 s of game time. The cost per frame
+// follows the number of ghosts due, not the number on the level.
+void benchScheduler() {
+    std::vector<Position> open;
+    MazeGrid maze = hunterMaze({"2001x2001", 2001, 2001}, open);
+    std::mt19937 gen(61);
+    std::shuffle(open.begin(), open.end(), gen);
+    struct Mix {
+        const char* label;
+        int minSpeed, maxSpeed;
+    };
+    const Mix mixes[] = {{"all speed 100 ", 100, 100}, {"speeds 100-1000", 100, 1000},
+                         {"all speed 1000", 1000, 1000}};
+    const int count = 100000;
+    for (const Mix& mix : mixes) {
+        GhostManager ghosts(3, 67);
+        std::uniform_int_distribution<int> speed(mix.minSpeed / 100, mix.maxSpeed / 100);
+        for (int i = 0; i < count; ++i) {
+            ghosts.addGhost(maze, open[i], static_cast<GhostType>(i % 4), speed(gen) * 100);
+        }
+        Position player(1, 1);
+        ghosts.advanceTo(0, player, maze);
+
+        const int frames = 200;
+        size_t woken = 0;
+        auto start = Clock::now();
+        for (int f = 1; f <= frames; ++f) {
+            ghosts.advanceTo(f * 100, player, maze);
+            woken += ghosts.getLastDueCount();
+        }
+        double frameUs = elapsedMs(start) * 1000.0 / frames;
+        std::cout << mix.label << "  " << std::setw(8) << woken / frames << " ghosts due/frame  "
+                  << std::fixed << std::setprecision(1) << std::setw(9) << frameUs << " us/frame  "
+                  << std::setw(6) << (woken ? frameUs * 1000.0 * frames / woken : 0.0)
+                  << " ns/due ghost\n";
+    }
+}
+
+// Cell-level BFS from one open cell to another with early exit: the search
+// the corridor graph replaces. dist and queue are caller-owned scratch.
+int cellBfsDistance(const MazeGrid& maze, Position from, Position to, std::vector<int>& dist,
+                    std::vector<std::uint32_t>& queue) {
+    std::fill(dist.begin(), dist.end(), -1);
+    const std::uint32_t target = static_cast<std::uint32_t>(maze.index(to.x, to.y));
+    const int w = maze.getWidth();
+    size_t head = 0, tail = 0;
+    queue[tail++] = static_cast<std::uint32_t>(maze.index(from.x, from.y));
+    dist[queue[0]] = 0;
+    while (head < tail) {
+        std::uint32_t cur = queue[head++];
+        if (cur == target) return dist[cur];
+        int x = static_cast<int>(cur % w), y = static_cast<int>(cur / w);
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = x + NeighborMasks::kDx[dir], ny = y + NeighborMasks::kDy[dir];
+            if (!maze.inBounds(nx, ny) || maze(nx, ny) == '#') continue;
+            std::uint32_t n = static_cast<std::uint32_t>(maze.index(nx, ny));
+            if (dist[n] >= 0) continue;
+            dist[n] = dist[cur] + 1;
+            queue[tail++] = n;
+        }
+    }
+    return -1;
+}
+
+// Corridor graph: build time and size against the open cells, random
+// point-to-point distance queries against cell BFS (answers must match),
+// and the patrol routes of a Hard swarm. Returns false on a mismatch.
+bool benchCorridors() {
+    bool ok = true;
+    const MazeSize sizes[] = {{"71x41", 71, 41}, {"201x201", 201, 201}, {"1001x1001", 1001, 1001}};
+    for (const MazeSize& size : sizes) {
+        std::vector<Position> open;
+        MazeGrid maze = hunterMaze(size, open);
+        CorridorGraph graph;
+        const int builds = 5;
+        auto start = Clock::now();
+        for (int i = 0; i < builds; ++i) graph.build(maze);
+        double buildMs = elapsedMs(start) / builds;
+
+        std::mt19937 gen(71);
+        auto randomOpen = [&]() { return open[std::uniform_int_distribution<size_t>(0, open.size() - 1)(gen)]; };
+        const int queries = size.width > 500 ? 50 : 500;
+        std::vector<std::pair<Position, Position>> pairs;
+        for (int i = 0; i < queries; ++i) pairs.emplace_back(randomOpen(), randomOpen());
+
+        std::vector<int> dist(maze.cellCount());
+        std::vector<std::uint32_t> queue(maze.cellCount());
+        std::vector<int> expected;
+        start = Clock::now();
+        for (const auto& q : pairs) expected.push_back(cellBfsDistance(maze, q.first, q.second, dist, queue));
+        double bfsUs = elapsedMs(start) * 1000.0 / queries;
+
+        int mismatches = 0;
+        size_t searched = 0;
+        start = Clock::now();
+        for (int i = 0; i < queries; ++i) {
+            const auto& q = pairs[i];
+            std::int32_t d = graph.distance(q.first.x, q.first.y, q.second.x, q.second.y);
+            searched += graph.getLastSearchNodes();
+            if (d != expected[i]) ++mismatches;
+        }
+        double graphUs = elapsedMs(start) * 1000.0 / queries;
+        ok = ok && mismatches == 0;
+
+        std::cout << std::left << std::setw(10) << size.label << std::right << std::setw(8) << open.size()
+                  << " open cells -> " << std::setw(6) << graph.nodeCount() << " nodes, " << std::setw(6)
+                  << graph.edgeCount() << " edges, build " << std::fixed << std::setprecision(3) << buildMs
+                  << " ms\n           distance query: cell BFS " << std::setprecision(1) << std::setw(8)
+                  << bfsUs << " us, graph " << std::setw(7) << graphUs << " us (" << searched / queries
+                  << " nodes searched), " << std::setprecision(1) << bfsUs / graphUs << "x, "
+                  << (mismatches == 0 ? "answers match" : "MISMATCH") << "\n";
+    }
+
+    // Patrol routes: every fourth ghost of the Hard mix is a guard
+    std::vector<Position> open;
+    MazeGrid maze = hunterMaze({"201x201", 201, 201}, open);
+    GhostManager ghosts(3, 73);
+    ghosts.initializeGhosts(maze, ghosts.planGhostSpawns(maze.getWidth(), maze.getHeight(), maze, 400));
+    int guards = 0, loops = 0, routed = 0;
+    size_t routeCells = 0;
+    bool adjacent = true;
+    for (int id = 0; id < ghosts.getGhostCount(); ++id) {
+        if (ghosts.getGhostType(id) != PATROL_GUARD) continue;
+        ++guards;
+        std::vector<Position> route = ghosts.getPatrolRoute(id);
+        if (route.empty()) continue;
+        ++routed;
+        loops += ghosts.isPatrolLoop(id);
+        routeCells += route.size();
+        size_t steps = ghosts.isPatrolLoop(id) ? route.size() : route.size() - 1;
+        for (size_t i = 0; i < steps; ++i) {
+            const Position& a = route[i];
+            const Position& b = route[(i + 1) % route.size()];
+            adjacent = adjacent && std::abs(a.x - b.x) + std::abs(a.y - b.y) == 1;
+        }
+    }
+    ok = ok && adjacent;
+    std::cout << "201x201 patrols: " << guards << " guards, " << routed << " with routes, " << loops
+              << " loops, " << (routed ? routeCells / routed : 0) << " cells per route, "
+              << (adjacent ? "every step adjacent" : "NON-ADJACENT STEP") << "\n";
+    return ok;
+}
+
+// Hierarchical pathfinder on big mazes: build time and abstract graph size,
+// cold point-to-point queries and queries toward a cached goal (the exit
+// hint, spawnpoints) against cell BFS, full path refinement, and a query
+// after knocking out walls. Answers must agree with BFS on reachability and
+// never be shorter; the excess over the true distance is reported. Returns
+// false on a wrong answer or a broken path.
+bool benchHpa() {
+    bool ok = true;
+    const MazeSize sizes[] = {{"1001x1001", 1001, 1001}, {"2001x2001", 2001, 2001}, {"4001x4001", 4001, 4001}};
+    for (const MazeSize& size : sizes) {
+        std::vector<Position> open;
+        MazeGrid maze = hunterMaze(size, open);
+        HierarchicalPathfinder paths;
+        auto start = Clock::now();
+        paths.build(maze);
+        double buildMs = elapsedMs(start);
+
+        std::mt19937 gen(83);
+        auto randomOpen = [&]() { return open[std::uniform_int_distribution<size_t>(0, open.size() - 1)(gen)]; };
+        const int queries = size.width > 2500 ? 10 : 30;
+        std::vector<std::pair<Position, Position>> pairs;
+        for (int i = 0; i < queries; ++i) pairs.emplace_back(randomOpen(), randomOpen());
+        const Position exit(size.width - 2, size.height - 2);
+        std::vector<Position> starts;
+        for (int i = 0; i < queries; ++i) starts.push_back(randomOpen());
+
+        std::vector<int> dist(maze.cellCount());
+        std::vector<std::uint32_t> queue(maze.cellCount());
+        std::vector<int> expected, expectedExit;
+        start = Clock::now();
+        for (const auto& q : pairs) expected.push_back(cellBfsDistance(maze, q.first, q.second, dist, queue));
+        double bfsUs = elapsedMs(start) * 1000.0 / queries;
+        for (const Position& p : starts) expectedExit.push_back(cellBfsDistance(maze, p, exit, dist, queue));
+
+        int wrong = 0, excess = 0;
+        auto check = [&](std::int32_t got, int want) {
+            if (want < 0) {
+                wrong += got != HierarchicalPathfinder::kUnreachable;
+            } else if (got == HierarchicalPathfinder::kUnreachable || got < want) {
+                ++wrong;
+            } else {
+                excess = std::max(excess, got - want);
+            }
+        };
+
+        // Cold: a different goal every time, so each query is an abstract A*
+        size_t expanded = 0;
+        start = Clock::now();
+        for (int i = 0; i < queries; ++i) {
+            const auto& q = pairs[i];
+            check(paths.distance(maze, q.first.x, q.first.y, q.second.x, q.second.y), expected[i]);
+            expanded += paths.getStats().lastExpanded;
+        }
+        double coldUs = elapsedMs(start) * 1000.0 / queries;
+
+        // Cached: the second query toward the exit builds its goal tree
+        paths.distance(maze, starts[0].x, starts[0].y, exit.x, exit.y);
+        start = Clock::now();
+        paths.distance(maze, starts[0].x, starts[0].y, exit.x, exit.y);
+        double treeMs = elapsedMs(start);
+        start = Clock::now();
+        for (int i = 0; i < queries; ++i) {
+            check(paths.distance(maze, starts[i].x, starts[i].y, exit.x, exit.y), expectedExit[i]);
+        }
+        double cachedUs = elapsedMs(start) * 1000.0 / queries;
+
+        // Refinement: every cell of the route, walkable and one step apart
+        std::vector<pos> path;
+        bool connected = true;
+        start = Clock::now();
+        for (int i = 0; i < queries; ++i) {
+            const auto& q = pairs[i];
+            if (!paths.findPath(maze, q.first.x, q.first.y, q.second.x, q.second.y, path)) continue;
+            for (size_t c = 0; c + 1 < path.size(); ++c) {
+                connected = connected && std::abs(path[c].x - path[c + 1].x) + std::abs(path[c].y - path[c + 1].y) == 1 &&
+                            maze(path[c + 1].x, path[c + 1].y) != '#';
+            }
+            connected = connected && path.back().x == q.second.x && path.back().y == q.second.y;
+        }
+        double pathUs = elapsedMs(start) * 1000.0 / queries;
+
+        // Open 200 walls between two open cells, then re-ask the cold pairs
+        int opened = 0;
+        while (opened < 200) {
+            int x = std::uniform_int_distribution<>(1, size.width - 2)(gen);
+            int y = std::uniform_int_distribution<>(1, size.height - 2)(gen);
+            if (maze(x, y) != '#') continue;
+            bool across = (maze(x - 1, y) != '#' && maze(x + 1, y) != '#') || (maze(x, y - 1) != '#' && maze(x, y + 1) != '#');
+            if (!across) continue;
+            maze(x, y) = ' ';
+            paths.markDirty(x, y);
+            ++opened;
+        }
+        const long rebuiltBefore = paths.getStats().rebuiltClusters;
+        start = Clock::now();
+        paths.distance(maze, pairs[0].first.x, pairs[0].first.y, pairs[0].second.x, pairs[0].second.y);
+        double rebuildMs = elapsedMs(start);
+        for (int i = 0; i < queries; ++i) {
+            const auto& q = pairs[i];
+            check(paths.distance(maze, q.first.x, q.first.y, q.second.x, q.second.y),
+                  cellBfsDistance(maze, q.first, q.second, dist, queue));
+        }
+        ok = ok && wrong == 0 && connected;
+
+        std::cout << std::left << std::setw(10) << size.label << std::right << std::fixed << std::setprecision(1)
+                  << " build " << std::setw(7) << buildMs << " ms, " << paths.nodeCount() << " abstract nodes ("
+                  << std::setprecision(2) << 100.0 * paths.nodeCount() / open.size() << "% of open cells), "
+                  << paths.memoryBytes() / 1024 << " KB\n" << std::setprecision(1)
+                  << "           cell BFS " << std::setw(8) << bfsUs << " us, cold " << std::setw(7) << coldUs
+                  << " us (" << expanded / queries << " nodes), cached goal " << std::setw(6) << cachedUs
+                  << " us (tree " << treeMs << " ms), full path " << std::setw(7) << pathUs << " us\n"
+                  << "           " << opened << " walls opened: " << paths.getStats().rebuiltClusters - rebuiltBefore
+                  << " clusters rebuilt in " << std::setprecision(2) << rebuildMs << " ms; "
+                  << (wrong == 0 ? "answers valid" : "WRONG ANSWER") << ", max excess " << excess << " steps, "
+                  << (connected ? "paths connected" : "BROKEN PATH") << "\n";
+    }
+    return ok;
+}
+
+// New-game latency through the level pool versus building on the spot,
+// restarting every 50 ms like an impatient player on Hard
+void benchLevelPool() {
+    NullBuffer sink;
+    std::streambuf* old = std::cout.rdbuf(&sink);  // silence spawnpoint logging
+    const int games = 40;
+    double syncMs = 0.0, pooledMs = 0.0, pooledMaxMs = 0.0;
+    LevelPoolStats stats;
+    {
+        GameManager game;
+        for (int i = 0; i < games; ++i) {
+            auto start = Clock::now();
+            game.initializeGame(3);
+            syncMs += elapsedMs(start);
+        }
+
+        GameManager pooled;
+        pooled.enableLevelPool(2, 4);
+        while (pooled.getLevelPool()->getReadyCount(3) < 4) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        for (int i = 0; i < games; ++i) {
+            auto start = Clock::now();
+            pooled.initializeGame(3);
+            double ms = elapsedMs(start);
+            pooledMs += ms;
+            pooledMaxMs = std::max(pooledMaxMs, ms);
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        stats = pooled.getLevelPool()->getStats();
+    }
+    std::cout.rdbuf(old);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Hard new game, synchronous  " << std::setw(8) << syncMs / games << " ms avg\n"
+              << "Hard new game, level pool   " << std::setw(8) << pooledMs / games << " ms avg, "
+              << pooledMaxMs << " ms max\n"
+              << "pool hits " << stats.hits << ", misses " << stats.misses
+              << ", refills " << stats.refills << ", refill latency avg "
+              << stats.avgRefillMs << " ms, max " << stats.maxRefillMs << " ms\n";
+}
+
+// Just enough of a terminal to replay the renderer's output: cursor moves,
+// colors, clears and UTF-8 glyphs, one per column
+class VirtualTerminal {
+public:
+    struct Cell {
+        std::string glyph = " ";
+        std::string pen;
+        bool operator==(const Cell& other) const { return glyph == other.glyph && pen == other.pen; }
+    };
+
+    void feed(const std::string& bytes) {
+        size_t i = 0;
+        while (i < bytes.size()) {
+            const unsigned char c = static_cast<unsigned char>(bytes[i]);
+            if (c == 0x1b && i + 1 < bytes.size() && bytes[i + 1] == '[') {
+                size_t end = i + 2;
+                while (end < bytes.size() && (bytes[end] < 0x40 || bytes[end] > 0x7e)) end++;
+                control(bytes.substr(i + 2, end - i - 2), bytes[end]);
+                i = end + 1;
+            } else if (c == '\n') {
+                row++;
+                col = 0;
+                i++;
+            } else {
+                const size_t length = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+                Cell& cell = at(row, col++);
+                cell.glyph = bytes.substr(i, length);
+                cell.pen = pen;
+                i += length;
+            }
+        }
+    }
+    // Same glyphs in the same colors on the first `count` rows
+    bool sameRows(const VirtualTerminal& other, size_t count) const {
+        for (size_t r = 0; r < count; r++) {
+            const bool mine = r < rows.size(), theirs = r < other.rows.size();
+            if (mine != theirs || (mine && rows[r] != other.rows[r])) return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<std::vector<Cell>> rows;
+    std::string pen;
+    size_t row = 0, col = 0;
+
+    Cell& at(size_t r, size_t c) {
+        if (rows.size() <= r) rows.resize(r + 1);
+        if (rows[r].size() <= c) rows[r].resize(c + 1);
+        return rows[r][c];
+    }
+    void control(const std::string& params, char command) {
+        if (command == 'H') {
+            const size_t split = params.find(';');
+            row = params.empty() ? 0 : std::stoul(params.substr(0, split)) - 1;
+            col = split == std::string::npos ? 0 : std::stoul(params.substr(split + 1)) - 1;
+        } else if (command == 'm') {
+            // Codes starting with a reset replace the pen, others add to it
+            pen = (params.empty() || params[0] == '0') ? params : pen + ";" + params;
+        } else if (command == 'J') {
+            rows.clear();
+        } else if (command == 'K' && row < rows.size() && col < rows[row].size()) {
+            rows[row].resize(col);
+        }
+    }
+};
+
+// Renders a walking game twice per step: once as a diff against the last
+// frame and once redrawn in full. Frames go to /dev/null; the bytes of each
+// are replayed into virtual terminals, which must end up showing the same
+// screen. Allocations are counted around renderGame only.
+bool benchRender(const MazeSize& size) {
+    NullBuffer sink;
+    std::streambuf* old = std::cout.rdbuf(&sink);
+    const int devNull = ::open("/dev/null", O_WRONLY);
+    const int frames = size.width * size.height > 10000 ? 20 : 200;
+
+    struct Totals {
+        double ms = 0.0, encodeUs = 0.0;
+        size_t bytes = 0, changedCells = 0, runs = 0;
+        long allocs = 0;
+    };
+    Totals diff, full;
+    size_t firstBytes = 0;
+    int mismatches = 0;
+    {
+        GameManager game;
+        game.initializeGame(3, size.width, size.height);
+        GameRenderer diffRenderer, fullRenderer;
+        diffRenderer.setOutputFd(devNull);
+        fullRenderer.setOutputFd(devNull);
+        diffRenderer.setDebugHud(true);
+        fullRenderer.setDebugHud(true);
+        VirtualTerminal diffScreen, fullScreen;
+        std::mt19937 gen(11);
+        const int dx[] = {1, -1, 0, 0};
+        const int dy[] = {0, 0, 1, -1};
+
+        auto render = [&](GameRenderer& renderer, VirtualTerminal& screen, Totals* totals) {
+            const long allocs = gAllocations.load();
+            const auto start = Clock::now();
+            renderer.renderGame(game);
+            const double ms = elapsedMs(start);
+            const GameRenderer::FrameStats& stats = renderer.getLastFrameStats();
+            if (totals) {
+                totals->ms += ms;
+                totals->encodeUs += stats.encodeUs;
+                totals->allocs += gAllocations.load() - allocs;
+                totals->bytes += stats.bytes;
+                totals->changedCells += stats.changedCells;
+                totals->runs += stats.runs;
+            }
+            screen.feed(std::string(renderer.getLastFrame()));
+        };
+
+        // Two untimed frames first: the first is always drawn in full, and
+        // the UI lines alternate between two sets of strings that each grow
+        // once
+        for (int i = 0; i < frames + 2; ++i) {
+            if (i > 0) {
+                const int dir = static_cast<int>(gen() % 4);
+                game.handlePlayerMove(dx[dir], dy[dir]);
+                game.update();
+            }
+            render(diffRenderer, diffScreen, i >= 2 ? &diff : nullptr);
+            if (i == 0) firstBytes = diffRenderer.getLastFrameStats().bytes;
+            fullRenderer.invalidate();
+            render(fullRenderer, fullScreen, i >= 2 ? &full : nullptr);
+
+            // Everything above the HUD, whose numbers differ between the two
+            if (!diffScreen.sameRows(fullScreen, game.getHeight() + 6)) mismatches++;
+        }
+    }
+    std::cout.rdbuf(old);
+    ::close(devNull);
+
+    auto report = [frames](const char* label, const Totals& totals) {
+        std::cout << std::fixed << std::setprecision(3) << label << std::setw(8) << totals.ms / frames
+                  << " ms/frame, encode " << std::setw(8) << totals.encodeUs / frames << " us/frame, "
+                  << std::setw(8) << totals.bytes / frames << " bytes/frame, "
+                  << static_cast<double>(totals.allocs) / frames << " allocs/frame";
+    };
+    std::cout << size.label << "\n";
+    report("  full ", full);
+    std::cout << "\n";
+    report("  diff ", diff);
+    std::cout << std::setprecision(1) << " (" << static_cast<double>(diff.changedCells) / frames
+              << " cells, " << static_cast<double>(diff.runs) / frames << " runs)\n"
+              << "  first frame " << firstBytes << " bytes, "
+              << (mismatches ? "SCREENS DIFFER" : "screens match") << "\n";
+    return mismatches == 0;
+}
+
+// Render cost against the number of ghosts and chests on one maze size.
+// Diffed frames of an unchanged game cost only building and comparing the
+// cells, which is where the entities are looked up.
+void benchRenderEntities() {
+    NullBuffer sink;
+    std::streambuf* old = std::cout.rdbuf(&sink);
+    const int devNull = ::open("/dev/null", O_WRONLY);
+    struct Row {
+        int ghosts;
+        size_t chests;
+        double diffMs, fullMs;
+    };
+    std::vector<Row> rows;
+    const MazeSize sizes[] = {{"201x201", 201, 201}, {"501x501", 501, 501}};
+    for (const MazeSize& size : sizes) {
+        for (int ghostCount : {10, 100, 1000, 10000}) {
+            GameManager game;
+            game.setGhostCount(ghostCount);
+            game.initializeGame(3, size.width, size.height);
+            GameRenderer renderer;
+            renderer.setOutputFd(devNull);
+            renderer.renderGame(game);
+
+            const int frames = size.width > 300 ? 5 : 20;
+            auto start = Clock::now();
+            for (int i = 0; i < frames; ++i) renderer.renderGame(game);
+            const double diffMs = elapsedMs(start) / frames;
+            start = Clock::now();
+            for (int i = 0; i < frames; ++i) {
+                renderer.invalidate();
+                renderer.renderGame(game);
+            }
+            rows.push_back({game.getGhostManager()->getGhostCount(), game.getChests().size(), diffMs,
+                            elapsedMs(start) / frames});
+        }
+    }
+    std::cout.rdbuf(old);
+    ::close(devNull);
+
+    size_t i = 0;
+    for (const MazeSize& size : sizes) {
+        for (int k = 0; k < 4; ++k, ++i) {
+            std::cout << std::left << std::setw(10) << size.label << std::right << std::setw(7)
+                      << rows[i].ghosts << " ghosts " << std::setw(6) << rows[i].chests << " chests  "
+                      << std::fixed << std::setprecision(3) << "unchanged frame " << std::setw(9)
+                      << rows[i].diffMs << " ms, full frame " << std::setw(9) << rows[i].fullMs << " ms\n";
+        }
+    }
+}
+
+// An 80x24 terminal following a player who walks the exit hint on mazes
+// far larger than the screen, with the minimap on. Diffed and full frames
+// are replayed into virtual terminals as in benchRender; only what is in
+// view is drawn, so frame cost should not grow with the maze.
+bool benchViewport() {
+    NullBuffer sink;
+    const int devNull = ::open("/dev/null", O_WRONLY);
+    const int cols = 80, rows = 24;
+    bool ok = true;
+    const MazeSize sizes[] = {{"201x201", 201, 201}, {"501x501", 501, 501}, {"2001x2001", 2001, 2001}};
+    for (const MazeSize& size : sizes) {
+        std::streambuf* old = std::cout.rdbuf(&sink);
+        GameManager game;
+        game.initializeGame(3, size.width, size.height);
+
+        auto start = Clock::now();
+        MazePyramid pyramid;
+        pyramid.build(game.getMaze());
+        const double pyramidMs = elapsedMs(start);
+
+        // Renderers restore the terminal when destroyed; keep that in the sink
+        std::unique_ptr<GameRenderer> diffOwner(new GameRenderer()), fullOwner(new GameRenderer());
+        GameRenderer& diffRenderer = *diffOwner;
+        GameRenderer& fullRenderer = *fullOwner;
+        for (GameRenderer* renderer : {&diffRenderer, &fullRenderer}) {
+            renderer->setOutputFd(devNull);
+            renderer->setScreenSize(cols, rows);
+            renderer->setMinimap(true);
+            renderer->setDebugHud(true);
+        }
+        VirtualTerminal diffScreen, fullScreen;
+        game.toggleHint();
+        const int dx[] = {1, -1, 0, 0};
+        const int dy[] = {0, 0, 1, -1};
+
+        const int frames = 100;
+        double diffMs = 0.0;
+        size_t diffBytes = 0, fullBytes = 0;
+        int scrolls = 0, mismatches = 0;
+        for (int i = 0; i < frames + 1; ++i) {
+            const int viewX = diffRenderer.getViewX(), viewY = diffRenderer.getViewY();
+            if (i > 0) {
+                // Step onto the hint, which runs ahead of the player
+                for (int step = 0; step < 4; ++step) {
+                    const Player* player = game.getPlayer();
+                    for (int dir = 0; dir < 4; ++dir) {
+                        if (game.isHintCell(player->getX() + dx[dir], player->getY() + dy[dir])) {
+                            game.handlePlayerMove(dx[dir], dy[dir]);
+                            break;
+                        }
+                    }
+                }
+                game.update();
+            }
+            start = Clock::now();
+            diffRenderer.renderGame(game);
+            if (i > 0) {
+                diffMs += elapsedMs(start);
+                diffBytes += diffRenderer.getLastFrameStats().bytes;
+                if (diffRenderer.getViewX() != viewX || diffRenderer.getViewY() != viewY) scrolls++;
+            }
+            diffScreen.feed(std::string(diffRenderer.getLastFrame()));
+            fullRenderer.invalidate();
+            fullRenderer.renderGame(game);
+            if (i > 0) fullBytes += fullRenderer.getLastFrameStats().bytes;
+            fullScreen.feed(std::string(fullRenderer.getLastFrame()));
+            // The HUD is on the last row
+            if (!diffScreen.sameRows(fullScreen, rows - 1)) mismatches++;
+        }
+        const int viewWidth = diffRenderer.getViewWidth(), viewHeight = diffRenderer.getViewHeight();
+        diffOwner.reset();
+        fullOwner.reset();
+        std::cout.rdbuf(old);
+
+        std::cout << std::left << std::setw(10) << size.label << std::right << std::fixed
+                  << std::setprecision(3) << " view " << viewWidth << "x" << viewHeight << ": diff " << std::setw(6) << diffMs / frames
+                  << " ms/frame " << std::setw(6) << diffBytes / frames << " bytes/frame, full "
+                  << std::setw(6) << fullBytes / frames << " bytes/frame, " << scrolls << " scrolls, "
+                  << "pyramid " << std::setw(7) << pyramidMs << " ms " << pyramid.memoryBytes() / 1024
+                  << " KB, " << (mismatches ? "SCREENS DIFFER" : "screens match") << "\n";
+        ok = ok && mismatches == 0;
+    }
+    ::close(devNull);
+    return ok;
+}
+
+// Bytes per frame in each render mode, for the whole Hard maze on an
+// unbounded screen and for a large maze on an 80x24 terminal with the
+// minimap. The player walks the exit hint; diffed and full frames are
+// replayed into virtual terminals as in benchRender.
+bool benchRenderModes() {
+    NullBuffer sink;
+    const int devNull = ::open("/dev/null", O_WRONLY);
+    struct Setup {
+        MazeSize size;
+        int cols, rows;     // 0 x 0: the whole maze
+    };
+    const Setup setups[] = {{{"Hard 71x41", 71, 41}, 0, 0}, {{"501x501", 501, 501}, 80, 24}};
+    const RenderMode modes[] = {RENDER_BLOCKS, RENDER_HALF, RENDER_ASCII};
+    bool ok = true;
+    for (const Setup& setup : setups) {
+        for (RenderMode mode : modes) {
+            std::streambuf* old = std::cout.rdbuf(&sink);
+            GameManager game;
+            game.initializeGame(3, setup.size.width, setup.size.height);
+            std::unique_ptr<GameRenderer> diffOwner(new GameRenderer()), fullOwner(new GameRenderer());
+            GameRenderer& diffRenderer = *diffOwner;
+            GameRenderer& fullRenderer = *fullOwner;
+            for (GameRenderer* renderer : {&diffRenderer, &fullRenderer}) {
+                renderer->setOutputFd(devNull);
+                renderer->setScreenSize(setup.cols, setup.rows);
+                renderer->setMinimap(true);
+                renderer->setDebugHud(true);
+                renderer->setRenderMode(mode);
+            }
+            VirtualTerminal diffScreen, fullScreen;
+            game.toggleHint();
+            const int dx[] = {1, -1, 0, 0};
+            const int dy[] = {0, 0, 1, -1};
+
+            const int frames = 100;
+            double diffMs = 0.0;
+            size_t diffBytes = 0, fullBytes = 0, firstBytes = 0;
+            int mismatches = 0;
+            for (int i = 0; i < frames + 1; ++i) {
+                if (i > 0) {
+                    const Player* player = game.getPlayer();
+                    for (int dir = 0; dir < 4; ++dir) {
+                        if (game.isHintCell(player->getX() + dx[dir], player->getY() + dy[dir])) {
+                            game.handlePlayerMove(dx[dir], dy[dir]);
+                            break;
+                        }
+                    }
+                    game.update();
+                }
+                const auto start = Clock::now();
+                diffRenderer.renderGame(game);
+                if (i > 0) {
+                    diffMs += elapsedMs(start);
+                    diffBytes += diffRenderer.getLastFrameStats().bytes;
+                } else {
+                    firstBytes = diffRenderer.getLastFrameStats().bytes;
+                }
+                diffScreen.feed(std::string(diffRenderer.getLastFrame()));
+                fullRenderer.invalidate();
+                fullRenderer.renderGame(game);
+                if (i > 0) fullBytes += fullRenderer.getLastFrameStats().bytes;
+                fullScreen.feed(std::string(fullRenderer.getLastFrame()));
+
+                // Everything above the HUD, the fifth line under the frame
+                const int viewHeight = diffRenderer.getViewHeight();
+                const int frameRows = mode == RENDER_HALF ? (viewHeight + 3) / 2 : viewHeight + 2;
+                if (!diffScreen.sameRows(fullScreen, frameRows + 4)) mismatches++;
+            }
+            diffOwner.reset();
+            fullOwner.reset();
+            std::cout.rdbuf(old);
+
+            std::cout << std::left << std::setw(11) << setup.size.label << std::setw(7)
+                      << renderModeName(mode) << std::right << std::fixed << std::setprecision(3)
+                      << "first " << std::setw(6) << firstBytes << " bytes, full " << std::setw(6)
+                      << fullBytes / frames << " bytes/frame, diff " << std::setw(5) << diffBytes / frames
+                      << " bytes/frame " << std::setw(6) << diffMs / frames << " ms/frame, "
+                      << (mismatches ? "SCREENS DIFFER" : "screens match") << "\n";
+            ok = ok && mismatches == 0;
+        }
+    }
+    ::close(devNull);
+    return ok;
+}
+
+} // namespace
+
+// Runs every section, or only those named on the command line
+int main(int argc, char* argv[]) {
+    std::vector<std::string> only(argv + 1, argv + argc);
+    auto wants = [&only](const char* section) {
+        return only.empty() || std::find(only.begin(), only.end(), section) != only.end();
+    };
+
+    bool ok = true;
+    if (wants("grid")) {
+        std::cout << "== Maze grid: generation, scan kernel, ghost ticks ==\n";
+        for (const MazeSize& size : kSizes) benchGrid(size);
+    }
+    if (wants("algorithms")) {
+        std::cout << "\n== Carving algorithms ==\n";
+        benchAlgorithms();
+    }
+    if (wants("large")) {
+        std::cout << "\n== Large maze generation (iterative carving) ==\n";
+        for (const MazeSize& size : kLargeSizes) benchLargeGenerate(size);
+    }
+    if (wants("tiled")) {
+        std::cout << "\n== Tiled parallel carving (" << std::thread::hardware_concurrency()
+                  << " hardware threads) ==\n";
+        const MazeSize sizes[] = {{"4001x4001", 4001, 4001}, {"8001x8001", 8001, 8001}};
+        for (const MazeSize& size : sizes) {
+            benchTiled(size, ALGO_BACKTRACKER, 8);
+            benchTiled(size, ALGO_KRUSKAL, 8);
+        }
+    }
+    if (wants("stream")) {
+        std::cout << "\n== Streaming Eller generation to disk ==\n";
+        const MazeSize sizes[] = {{"1001x1001", 1001, 1001}, {"10001x10001", 10001, 10001},
+                                  {"40001x40001", 40001, 40001}};
+        for (const MazeSize& size : sizes) benchStream(size);
+    }
+    if (wants("openareas")) {
+        std::cout << "\n== removeOpenAreas: full rescans vs worklist ==\n";
+        benchRemoveOpenAreas();
+    }
+    if (wants("bitboard")) {
+        std::cout << "\n== Post-processing passes: MazeGrid vs bitboard kernels ==\n";
+        benchBitboard();
+    }
+    if (wants("hunters")) {
+        std::cout << "\n== Hunters on a shared flow field ==\n";
+        ok = benchHunters() && ok;
+    }
+    if (wants("occupancy")) {
+        std::cout << "\n== Ghost ticks with the occupancy grid ==\n";
+        benchOccupancy();
+    }
+    if (wants("walkable")) {
+        std::cout << "\n== Walkable-cell index ==\n";
+        benchWalkable();
+    }
+    if (wants("swarm")) {
+        std::cout << "\n== Ghost swarms (structure of arrays) ==\n";
+        benchSwarm();
+    }
+    if (wants("ghostthreads")) {
+        std::cout << "\n== Parallel ghost move pass (" << std::thread::hardware_concurrency()
+                  << " hardware threads) ==\n";
+        ok = benchGhostThreads() && ok;
+    }
+    if (wants("allocs")) {
+        std::cout << "\n== Heap allocations per ghost tick ==\n";
+        ok = benchAllocations({"201x201", 201, 201}, 200, 1) && ok;
+        ok = benchAllocations({"401x401", 401, 401}, 10000, 2) && ok;
+    }
+    if (wants("scheduler")) {
+        std::cout << "\n== Event-driven ghost scheduler ==\n";
+        benchScheduler();
+    }
+    if (wants("lod")) {
+        std::cout << "\n== Ghost level of detail ==\n";
+        ok = benchLod() && ok;
+    }
+    if (wants("corridors")) {
+        std::cout << "\n== Corridor graph ==\n";
+        ok = benchCorridors() && ok;
+    }
+    if (wants("hpa")) {
+        std::cout << "\n== Hierarchical pathfinder ==\n";
+        ok = benchHpa() && ok;
+    }
+    if (wants("pool")) {
+        std::cout << "\n== Background level pool ==\n";
+        benchLevelPool();
+    }
+    if (wants("render")) {
+        std::cout << "\n== Rendering ==\n";
+        for (const MazeSize& size : kSizes) {
+            if (size.width * size.height > 300000) continue; // full frames run to tens of MB to replay
+            ok = benchRender(size) && ok;
+        }
+    }
+    if (wants("viewport")) {
+        std::cout << "\n== Viewport on an 80x24 terminal ==\n";
+        ok = benchViewport() && ok;
+    }
+    if (wants("entities")) {
+        std::cout << "\n== Render cost by entity count ==\n";
+        benchRenderEntities();
+    }
+    if (wants("modes")) {
+        std::cout << "\n== Render modes ==\n";
+        ok = benchRenderModes() && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -8,12 +8,19 @@
 #include "chest.h"
 #include "pos.h"
 #include "Player.h"
+#include "rng.h"
 using namespace std;
 
-vector<pos> generate_chests(vector<vector<char>>& maze, int difficulty, const vector<pos>& wallPositions){
+vector<pos> generate_chests(MazeGrid& maze, int difficulty, const vector<pos>& wallPositions){
+    mt19937 gen = makeRng(randomSeed(), RNG_CHESTS);
+    return generate_chests(maze, difficulty, wallPositions, gen);
+}
+
+vector<pos> generate_chests(MazeGrid& maze, int difficulty, const vector<pos>& wallPositions,
+                            mt19937& gen){
     vector<pos> chests;
-    int height = maze.size();
-    int width = maze[0].size(); // The area of the map
+    int height = maze.getHeight();
+    int width = maze.getWidth(); // The area of the map
 
     int chestCount = 0;
     switch (difficulty){
@@ -22,8 +29,6 @@ vector<pos> generate_chests(vector<vector<char>>& maze, int difficulty, const ve
         case 3: chestCount = 0; break;
     } // different difficulties have different number of chests
 
-    random_device rd;
-    mt19937 gen(rd());
     uniform_int_distribution<> disX(1, width - 2);
     uniform_int_distribution<> disY(1, height - 2);
 
@@ -32,7 +37,7 @@ vector<pos> generate_chests(vector<vector<char>>& maze, int difficulty, const ve
         int x = disX(gen);
         int y = disY(gen);
 
-        if (maze[y][x] == ' '){
+        if (maze(x, y) == ' '){
             bool isWall = false;
             for (const pos& wall : wallPositions){
                 if (wall.x == x && wall.y == y){
@@ -51,7 +56,7 @@ vector<pos> generate_chests(vector<vector<char>>& maze, int difficulty, const ve
             }
             
             if (!isWall && !isDuplicate){ //generate a chest only when it isn't on the wall and not a duplicate
-                maze[y][x] = 'C'; // Use 'C' to represent chest
+                maze(x, y) = 'C'; // Use 'C' to represent chest
                 chests.push_back(pos{x, y});
             }
         }
@@ -88,10 +93,13 @@ extern void stop_ghost();
 extern void mingdao();
 
 void benefit(Player* player) {
+    std::mt19937 gen = makeRng(randomSeed(), RNG_EVENTS);
+    benefit(player, gen);
+}
+
+void benefit(Player* player, std::mt19937& gen) {
     if (!player) return;
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
     switch (gen() % 3 + 1) { // randomly returns 1/2/3, each one is associated with a kind of benefit
         case 1: player->increasePlayerHealth(); break; // the first benefit: add one blood to the player
         case 2: stop_ghost(); break; // the second benefit: stop ghost for three seconds
@@ -2,14 +2,20 @@
 #ifndef CHEST_H
 #define CHEST_H
 
+#include <random>
 #include <vector>
 #include "pos.h"
+#include "maze_grid.h"
 #include "Player.h"
 
-std::vector<pos> generate_chests(std::vector<std::vector<char>>& maze, int difficulty, const std::vector<pos>& wallPositions);
+std::vector<pos> generate_chests(MazeGrid& maze, int difficulty, const std::vector<pos>& wallPositions);
+// Same, drawing positions from gen (e.g. the level's RNG_CHESTS stream)
+std::vector<pos> generate_chests(MazeGrid& maze, int difficulty, const std::vector<pos>& wallPositions,
+                                 std::mt19937& gen);
 bool meet_chest(pos pos_player, std::vector<pos> pos_chests);
 std::vector<pos> clear_chest(pos pos_player, std::vector<pos> pos_chests);
 void benefit(Player* player);  // Updated to take Player pointer
+void benefit(Player* player, std::mt19937& gen);  // Rolls the benefit with gen
 
 // Global functions defined in GameManager.cpp
 extern void stop_ghost();
@@ -1,19 +1,28 @@
 #ifndef CHEST_H
 #define CHEST_H
 
+#include <cstdint>
+#include <random>
 #include <vector>
 #include "pos.h"
+#include "maze_grid.h"
+#include "walkable_index.h"
 
 struct pos;
 
 class ChestGenerator {
 public:
+    // Chests are drawn from walkable and taken out of it. They stay off
+    // solutionPath (grid indices from start to exit, as published by
+    // MazeGenerator) and off the cells next to start and exit.
     static std::vector<pos> generateChests(
-        std::vector<std::vector<char>>& maze,
+        const MazeGrid& maze,
+        WalkableIndex& walkable,
+        const std::vector<std::uint32_t>& solutionPath,
         int startX, int startY,
         int exitX, int exitY,
         int difficulty,
-        char chestChar = '$'
+        std::mt19937& gen
     );
 };
 
@@ -0,0 +1,258 @@
+#include "corridor_graph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+const std::uint32_t CorridorGraph::kNone;
+const std::int32_t CorridorGraph::kUnreachable;
+const std::uint32_t CorridorGraph::kCorridorBit;
+
+CorridorGraph::CorridorGraph() : width(0), height(0), searchStamp(0), lastSearchNodes(0) {}
+
+void CorridorGraph::build(const MazeGrid& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    nodes.clear();
+    edges.clear();
+    corridorCells.clear();
+    corridorEdge.clear();
+    cellRef.assign(maze.cellCount(), kNone);
+
+    // Junctions and dead ends become nodes
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (maze(x, y) == '#') continue;
+            int degree = (x > 0 && maze(x - 1, y) != '#') + (x + 1 < width && maze(x + 1, y) != '#') +
+                         (y > 0 && maze(x, y - 1) != '#') + (y + 1 < height && maze(x, y + 1) != '#');
+            if (degree != 2) {
+                std::uint32_t cell = static_cast<std::uint32_t>(maze.index(x, y));
+                cellRef[cell] = static_cast<std::uint32_t>(nodes.size());
+                nodes.push_back(cell);
+            }
+        }
+    }
+
+    // Every corridor leaving a node, once: from whichever end reaches it
+    // first, or from the lower node for two adjacent nodes
+    const std::size_t junctions = nodes.size();
+    for (std::uint32_t n = 0; n < junctions; ++n) {
+        pos p = cellPos(nodes[n]);
+        const int dx[4] = {-1, 1, 0, 0}, dy[4] = {0, 0, -1, 1};
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = p.x + dx[dir], ny = p.y + dy[dir];
+            if (!maze.inBounds(nx, ny) || maze(nx, ny) == '#') continue;
+            std::uint32_t cell = static_cast<std::uint32_t>(maze.index(nx, ny));
+            std::uint32_t ref = cellRef[cell];
+            if (ref == kNone) {
+                traceEdge(maze, n, cell);
+            } else if (!(ref & kCorridorBit) && n < ref) {
+                edges.push_back(Edge{n, ref, 1, static_cast<std::uint32_t>(corridorCells.size())});
+            }
+        }
+    }
+
+    // Whatever is left are rings with no junction: one cell of each becomes
+    // a node with a loop edge
+    for (std::uint32_t cell = 0; cell < cellRef.size(); ++cell) {
+        if (cellRef[cell] != kNone || maze.data()[cell] == '#') continue;
+        std::uint32_t n = static_cast<std::uint32_t>(nodes.size());
+        cellRef[cell] = n;
+        nodes.push_back(cell);
+        pos p = cellPos(cell);
+        std::uint32_t first = p.x + 1 < width && maze(p.x + 1, p.y) != '#'
+                                  ? cell + 1
+                                  : static_cast<std::uint32_t>(maze.index(p.x, p.y + 1));
+        traceEdge(maze, n, first);
+    }
+
+    // Adjacency lists
+    nodeEdgeStart.assign(nodes.size() + 1, 0);
+    for (const Edge& e : edges) {
+        ++nodeEdgeStart[e.a + 1];
+        ++nodeEdgeStart[e.b + 1];
+    }
+    for (std::size_t n = 0; n < nodes.size(); ++n) nodeEdgeStart[n + 1] += nodeEdgeStart[n];
+    nodeEdges.resize(nodeEdgeStart.back());
+    std::vector<std::uint32_t> fill(nodeEdgeStart.begin(), nodeEdgeStart.end() - 1);
+    for (std::uint32_t e = 0; e < edges.size(); ++e) {
+        nodeEdges[fill[edges[e].a]++] = e;
+        nodeEdges[fill[edges[e].b]++] = e;
+    }
+
+    dist.assign(nodes.size(), 0);
+    parentEdge.assign(nodes.size(), kNone);
+    stamps.assign(nodes.size(), 0);
+    searchStamp = 0;
+    heap.clear();
+}
+
+void CorridorGraph::traceEdge(const MazeGrid& maze, std::uint32_t from, std::uint32_t first) {
+    const std::uint32_t edgeId = static_cast<std::uint32_t>(edges.size());
+    const std::uint32_t start = static_cast<std::uint32_t>(corridorCells.size());
+    const std::uint32_t stride = static_cast<std::uint32_t>(width);
+    std::uint32_t prev = nodes[from], cur = first, length = 1;
+    while (cellRef[cur] == kNone) {
+        cellRef[cur] = kCorridorBit | static_cast<std::uint32_t>(corridorCells.size());
+        corridorCells.push_back(cur);
+        corridorEdge.push_back(edgeId);
+
+        // Two open neighbours: carry on through the one we did not come from
+        int x = static_cast<int>(cur % stride), y = static_cast<int>(cur / stride);
+        std::uint32_t next = cur;
+        if (x > 0 && maze(x - 1, y) != '#' && cur - 1 != prev) next = cur - 1;
+        else if (x + 1 < width && maze(x + 1, y) != '#' && cur + 1 != prev) next = cur + 1;
+        else if (y > 0 && maze(x, y - 1) != '#' && cur - stride != prev) next = cur - stride;
+        else if (y + 1 < height && maze(x, y + 1) != '#' && cur + stride != prev) next = cur + stride;
+        prev = cur;
+        cur = next;
+        ++length;
+    }
+    edges.push_back(Edge{from, cellRef[cur], length, start});
+}
+
+std::uint32_t CorridorGraph::nodeAt(int x, int y) const {
+    std::uint32_t ref = cellRef[static_cast<std::size_t>(y) * width + x];
+    return (ref & kCorridorBit) ? kNone : ref;
+}
+
+std::uint32_t CorridorGraph::edgeAt(int x, int y, std::uint32_t* stepsFromA) const {
+    std::uint32_t ref = cellRef[static_cast<std::size_t>(y) * width + x];
+    if (ref == kNone || !(ref & kCorridorBit)) return kNone;
+    std::uint32_t slot = ref & ~kCorridorBit;
+    std::uint32_t e = corridorEdge[slot];
+    if (stepsFromA) *stepsFromA = slot - edges[e].cellStart + 1;
+    return e;
+}
+
+void CorridorGraph::appendEdgeCells(std::uint32_t e, std::uint32_t from, std::vector<pos>& out) const {
+    const Edge& edge = edges[e];
+    const std::uint32_t interior = edge.length - 1;
+    if (edge.a == from) {
+        for (std::uint32_t i = 0; i < interior; ++i) out.push_back(cellPos(corridorCells[edge.cellStart + i]));
+        out.push_back(cellPos(nodes[edge.b]));
+    } else {
+        for (std::uint32_t i = interior; i > 0; --i) out.push_back(cellPos(corridorCells[edge.cellStart + i - 1]));
+        out.push_back(cellPos(nodes[edge.a]));
+    }
+}
+
+void CorridorGraph::beginSearch() {
+    if (++searchStamp == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        searchStamp = 1;
+    }
+    heap.clear();
+    lastSearchNodes = 0;
+}
+
+void CorridorGraph::relaxNode(std::uint32_t node, std::int32_t d, std::uint32_t viaEdge) {
+    if (stamps[node] == searchStamp && dist[node] <= d) return;
+    stamps[node] = searchStamp;
+    dist[node] = d;
+    parentEdge[node] = viaEdge;
+    heap.push_back((static_cast<std::uint64_t>(d) << 32) | node);
+    std::push_heap(heap.begin(), heap.end(), std::greater<std::uint64_t>());
+}
+
+void CorridorGraph::runSearch(std::uint32_t target, std::int32_t limit, std::uint32_t excluded) {
+    // Stops with the queue intact, so a later call can resume the search
+    while (!heap.empty() && static_cast<std::int32_t>(heap.front() >> 32) < limit) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<std::uint64_t>());
+        std::uint64_t top = heap.back();
+        heap.pop_back();
+        std::int32_t d = static_cast<std::int32_t>(top >> 32);
+        std::uint32_t node = static_cast<std::uint32_t>(top);
+        if (d > dist[node]) continue; // stale entry
+        ++lastSearchNodes;
+        for (const std::uint32_t* e = edgesBegin(node); e != edgesEnd(node); ++e) {
+            if (*e == excluded) continue;
+            relaxNode(otherEnd(*e, node), d + static_cast<std::int32_t>(edges[*e].length), *e);
+        }
+        if (node == target) break;
+    }
+}
+
+std::int32_t CorridorGraph::distance(int x0, int y0, int x1, int y1) {
+    const std::size_t s = static_cast<std::size_t>(y0) * width + x0;
+    const std::size_t t = static_cast<std::size_t>(y1) * width + x1;
+    if (cellRef[s] == kNone || cellRef[t] == kNone) return kUnreachable;
+    if (s == t) return 0;
+
+    beginSearch();
+    std::uint32_t startSteps = 0, targetSteps = 0;
+    std::uint32_t startEdge = edgeAt(x0, y0, &startSteps);
+    std::uint32_t targetEdge = edgeAt(x1, y1, &targetSteps);
+    if (startEdge == kNone) {
+        relaxNode(cellRef[s], 0, kNone);
+    } else {
+        const Edge& e = edges[startEdge];
+        relaxNode(e.a, static_cast<std::int32_t>(startSteps), kNone);
+        relaxNode(e.b, static_cast<std::int32_t>(e.length - startSteps), kNone);
+    }
+
+    if (targetEdge == kNone) {
+        runSearch(cellRef[t], kUnreachable, kNone);
+        return distanceTo(cellRef[t]);
+    }
+
+    // Target inside a corridor: the best of entering from either end, or
+    // walking along it when both cells share the corridor
+    const Edge& f = edges[targetEdge];
+    std::int32_t best = kUnreachable;
+    if (startEdge == targetEdge) {
+        best = std::abs(static_cast<std::int32_t>(startSteps) - static_cast<std::int32_t>(targetSteps));
+    }
+    runSearch(f.a, best, kNone);
+    if (distanceTo(f.a) != kUnreachable) {
+        best = std::min(best, distanceTo(f.a) + static_cast<std::int32_t>(targetSteps));
+    }
+    // f.b is either settled by now or only worth reaching below best
+    std::int32_t viaB = static_cast<std::int32_t>(f.length - targetSteps);
+    if (best != kUnreachable) {
+        runSearch(f.b, best - viaB, kNone);
+    } else {
+        runSearch(f.b, kUnreachable, kNone);
+    }
+    if (distanceTo(f.b) != kUnreachable) best = std::min(best, distanceTo(f.b) + viaB);
+    return best;
+}
+
+bool CorridorGraph::findLoop(std::uint32_t node, std::uint32_t e, std::uint32_t maxLength,
+                             std::vector<pos>& out) {
+    const Edge& first = edges[e];
+    if (first.length > maxLength) return false;
+    std::uint32_t other = otherEnd(e, node);
+    if (other == node) {
+        out.push_back(cellPos(nodes[node]));
+        appendEdgeCells(e, node, out);
+        out.pop_back(); // back at node
+        return true;
+    }
+
+    // Shortest way back from the far end without the first edge
+    beginSearch();
+    relaxNode(other, 0, kNone);
+    runSearch(node, static_cast<std::int32_t>(maxLength - first.length) + 1, e);
+    std::int32_t back = distanceTo(node);
+    if (back == kUnreachable || static_cast<std::uint32_t>(back) + first.length > maxLength) return false;
+
+    std::vector<std::uint32_t> chain;
+    for (std::uint32_t n = node; n != other; n = otherEnd(parentEdge[n], n)) chain.push_back(parentEdge[n]);
+    out.push_back(cellPos(nodes[node]));
+    appendEdgeCells(e, node, out);
+    std::uint32_t at = other;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        appendEdgeCells(*it, at, out);
+        at = otherEnd(*it, at);
+    }
+    out.pop_back(); // back at node
+    return true;
+}
+
+size_t CorridorGraph::memoryBytes() const {
+    return nodes.capacity() * sizeof(std::uint32_t) + edges.capacity() * sizeof(Edge) +
+           (nodeEdgeStart.capacity() + nodeEdges.capacity() + corridorCells.capacity() +
+            corridorEdge.capacity() + cellRef.capacity() + parentEdge.capacity() + stamps.capacity()) *
+               sizeof(std::uint32_t) +
+           dist.capacity() * sizeof(std::int32_t) + heap.capacity() * sizeof(std::uint64_t);
+}
@@ -0,0 +1,107 @@
+#ifndef CORRIDOR_GRAPH_H
+#define CORRIDOR_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+#include "pos.h"
+
+// The open cells of a maze compressed to a graph: junctions and dead ends
+// (any open cell without exactly two open neighbours) are nodes, and each
+// corridor of two-neighbour cells between them is one edge weighted by its
+// length in steps. A corridor that loops back without meeting a junction
+// gets one of its cells as a node. Searches then visit nodes instead of
+// cells, and every open cell maps back to its node or to its place on an
+// edge, so queries can start and end anywhere.
+class CorridorGraph {
+public:
+    static const std::uint32_t kNone = UINT32_MAX;
+    static const std::int32_t kUnreachable = INT32_MAX;
+
+    struct Edge {
+        std::uint32_t a, b;         // end nodes; a == b for a loop
+        std::uint32_t length;       // steps from a to b
+        std::uint32_t cellStart;    // interior cells, a to b: corridorCells[cellStart, + length - 1)
+    };
+
+    CorridorGraph();
+
+    void build(const MazeGrid& maze);
+    bool isBuiltFor(const MazeGrid& maze) const {
+        return width == maze.getWidth() && height == maze.getHeight() && !cellRef.empty();
+    }
+
+    size_t nodeCount() const { return nodes.size(); }
+    size_t edgeCount() const { return edges.size(); }
+    pos nodeCell(std::uint32_t node) const { return cellPos(nodes[node]); }
+    const Edge& edge(std::uint32_t e) const { return edges[e]; }
+    // Edges at node, as [begin, end) of edge ids; a loop edge is listed twice
+    const std::uint32_t* edgesBegin(std::uint32_t node) const { return nodeEdges.data() + nodeEdgeStart[node]; }
+    const std::uint32_t* edgesEnd(std::uint32_t node) const { return nodeEdges.data() + nodeEdgeStart[node + 1]; }
+    std::uint32_t otherEnd(std::uint32_t e, std::uint32_t node) const {
+        return edges[e].a == node ? edges[e].b : edges[e].a;
+    }
+
+    // Node on (x, y), or kNone for corridor cells and walls
+    std::uint32_t nodeAt(int x, int y) const;
+    // Edge through the corridor cell (x, y) and its steps from the edge's
+    // a end; kNone for nodes and walls
+    std::uint32_t edgeAt(int x, int y, std::uint32_t* stepsFromA = nullptr) const;
+
+    // Walking distance between two open cells (Dijkstra over the nodes),
+    // kUnreachable if either is a wall or they are not connected. Callers
+    // guarantee both cells are inside the maze.
+    std::int32_t distance(int x0, int y0, int x1, int y1);
+    // Shortest closed walk that leaves node along edge e and comes back
+    // without using e again, at most maxLength steps. Appends its cells,
+    // starting with node's and without repeating it, to out; false (out
+    // unchanged) if there is none.
+    bool findLoop(std::uint32_t node, std::uint32_t e, std::uint32_t maxLength, std::vector<pos>& out);
+    // Appends the cells of edge e walked from node `from`: the interior,
+    // then the far end's node cell
+    void appendEdgeCells(std::uint32_t e, std::uint32_t from, std::vector<pos>& out) const;
+
+    // Nodes popped by the most recent search
+    size_t getLastSearchNodes() const { return lastSearchNodes; }
+    size_t memoryBytes() const;
+
+private:
+    static const std::uint32_t kCorridorBit = 0x80000000u;
+
+    int width, height;
+    std::vector<std::uint32_t> nodes;           // grid index of each node
+    std::vector<Edge> edges;
+    std::vector<std::uint32_t> nodeEdgeStart;   // edges of node n: nodeEdges[start[n], start[n + 1])
+    std::vector<std::uint32_t> nodeEdges;
+    std::vector<std::uint32_t> corridorCells;   // grid indices of edge interiors
+    std::vector<std::uint32_t> corridorEdge;    // edge of each corridorCells entry
+    // Per cell: node id, kCorridorBit | index into corridorCells, or kNone
+    std::vector<std::uint32_t> cellRef;
+
+    // Dijkstra scratch, reused; a node's entries are valid when its stamp
+    // matches searchStamp
+    std::vector<std::int32_t> dist;
+    std::vector<std::uint32_t> parentEdge;
+    std::vector<std::uint32_t> stamps;
+    std::vector<std::uint64_t> heap;            // (distance << 32) | node
+    std::uint32_t searchStamp;
+    size_t lastSearchNodes;
+
+    pos cellPos(std::uint32_t cell) const {
+        return pos{static_cast<int>(cell % width), static_cast<int>(cell / width)};
+    }
+    // Follows the corridor leaving node `from` through cell `first` and adds
+    // it as an edge
+    void traceEdge(const MazeGrid& maze, std::uint32_t from, std::uint32_t first);
+    void beginSearch();
+    void relaxNode(std::uint32_t node, std::int32_t d, std::uint32_t viaEdge);
+    // Dijkstra from the seeded nodes, skipping edge excluded, until target
+    // has been expanded or the queue holds nothing shorter than limit
+    void runSearch(std::uint32_t target, std::int32_t limit, std::uint32_t excluded);
+    std::int32_t distanceTo(std::uint32_t node) const {
+        return stamps[node] == searchStamp ? dist[node] : kUnreachable;
+    }
+};
+
+#endif // CORRIDOR_GRAPH_H
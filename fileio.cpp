@@ -2,18 +2,125 @@
 #include <fstream>
 #include <sstream>
 #include <cstdio>   // std::rename, std::remove
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 static std::string tempFilenameFor(const std::string& filename) {
     return filename + ".tmp";
 }
 
+// Mazes of any size can be streamed to disk, but a game maze is capped at
+// MazeGrid::kMaxSide per side; refuse larger ones before allocating them
+static bool checkMazeSize(int width, int height, std::string& err) {
+    if (width <= MazeGrid::kMaxSide && height <= MazeGrid::kMaxSide) return true;
+    std::ostringstream oss;
+    oss << "Maze in save file is too large to play: " << width << "x" << height
+        << " (at most " << MazeGrid::kMaxSide << " per side)";
+    err = oss.str();
+    return false;
+}
+
+static const char* const kSeededMagic = "seeded";
+
+// Seeded format, after the magic line:
+// difficulty
+// width height
+// playerX playerY
+// exitX exitY
+// moves
+// seed algorithm tilesPerSide ghostCount (older saves stop at tilesPerSide:
+// the difficulty's default ghost count)
+// diffCount
+// then one "x y charCode" line per diff
+static void writeSeededSave(std::ostream& os, const GameState& state) {
+    os << kSeededMagic << "\n";
+    os << state.difficulty << "\n";
+    os << state.width << " " << state.height << "\n";
+    os << state.playerX << " " << state.playerY << "\n";
+    os << state.exitX << " " << state.exitY << "\n";
+    os << state.moves << "\n";
+    os << state.seed << " " << state.algorithm << " " << state.tilesPerSide << " " << state.ghostCount << "\n";
+    os << state.diffs.size() << "\n";
+    for (const CellDiff& d : state.diffs) {
+        os << d.x << " " << d.y << " " << static_cast<int>(static_cast<unsigned char>(d.cell)) << "\n";
+    }
+}
+
+// Reads a seeded save after its magic line
+static bool readSeededSave(std::istream& is, GameState& state, std::string& err) {
+    GameState s;
+    s.seeded = true;
+    if (!(is >> s.difficulty >> s.width >> s.height >> s.playerX >> s.playerY
+             >> s.exitX >> s.exitY >> s.moves)) {
+        err = "Failed to read seeded save header";
+        return false;
+    }
+    std::string seedLine;
+    std::getline(is >> std::ws, seedLine);
+    std::istringstream seedFields(seedLine);
+    if (!(seedFields >> s.seed >> s.algorithm >> s.tilesPerSide)) {
+        err = "Failed to read level seed";
+        return false;
+    }
+    if (!(seedFields >> s.ghostCount)) s.ghostCount = 0;
+    size_t diffCount = 0;
+    if (s.ghostCount < 0 || !(is >> diffCount)) {
+        err = "Failed to read level seed";
+        return false;
+    }
+    if (s.width <= 0 || s.height <= 0) {
+        err = "Invalid dimensions in save file";
+        return false;
+    }
+    if (!checkMazeSize(s.width, s.height, err)) return false;
+    if (s.playerX < 0 || s.playerX >= s.width || s.playerY < 0 || s.playerY >= s.height) {
+        err = "Player coordinates out of bounds in save file";
+        return false;
+    }
+    if (s.exitX < 0 || s.exitX >= s.width || s.exitY < 0 || s.exitY >= s.height) {
+        err = "Exit coordinates out of bounds in save file";
+        return false;
+    }
+    if (diffCount > static_cast<size_t>(s.width) * s.height) {
+        err = "Too many cell diffs in save file";
+        return false;
+    }
+    s.diffs.resize(diffCount);
+    for (CellDiff& d : s.diffs) {
+        int code;
+        // Only chests change during play: taken (' ') or placed ('C')
+        if (!(is >> d.x >> d.y >> code) || d.x < 0 || d.x >= s.width || d.y < 0 ||
+            d.y >= s.height || (code != ' ' && code != 'C')) {
+            err = "Invalid cell diff in save file";
+            return false;
+        }
+        d.cell = static_cast<char>(code);
+    }
+    state = std::move(s);
+    return true;
+}
+
+// True when filename starts with the seeded-save magic line
+static bool isSeededSave(const std::string& filename) {
+    std::ifstream ifs(filename);
+    std::string first;
+    return ifs >> first && first == kSeededMagic;
+}
+
 bool saveGameToFile(const std::string& filename, const GameState& state, std::string& err) {
     if (state.width <= 0 || state.height <= 0) {
         err = "Invalid dimensions in GameState";
         return false;
     }
-    if ((int)state.maze_lines.size() != state.height) {
+    if (!state.seeded && (int)state.maze_lines.size() != state.height) {
         err = "Maze line count does not match height";
         return false;
     }
@@ -38,14 +145,18 @@ bool saveGameToFile(const std::string& filename, const GameState& state, std::st
     // exitX exitY
     // moves
     // then the maze lines
-    ofs << state.difficulty << "\n";
-    ofs << state.width << " " << state.height << "\n";
-    ofs << state.playerX << " " << state.playerY << "\n";
-    ofs << state.exitX << " " << state.exitY << "\n";
-    ofs << state.moves << "\n";
+    if (state.seeded) {
+        writeSeededSave(ofs, state);
+    } else {
+        ofs << state.difficulty << "\n";
+        ofs << state.width << " " << state.height << "\n";
+        ofs << state.playerX << " " << state.playerY << "\n";
+        ofs << state.exitX << " " << state.exitY << "\n";
+        ofs << state.moves << "\n";
 
-    for (const auto& line : state.maze_lines) {
-        ofs << line << "\n";
+        for (const auto& line : state.maze_lines) {
+            ofs << line << "\n";
+        }
     }
 
     if (!ofs.good()) {
@@ -81,7 +192,14 @@ bool loadGameFromFile(const std::string& filename, GameState& state, std::string
     int exitX, exitY;
     int moves;
 
-    if (!(ifs >> difficulty)) {
+    std::string first;
+    if (!(ifs >> first)) {
+        err = "Failed to read difficulty";
+        return false;
+    }
+    if (first == kSeededMagic) return readSeededSave(ifs, state, err);
+    std::istringstream firstField(first);
+    if (!(firstField >> difficulty)) {
         err = "Failed to read difficulty";
         return false;
     }
@@ -89,6 +207,7 @@ bool loadGameFromFile(const std::string& filename, GameState& state, std::string
         err = "Failed to read width and height";
         return false;
     }
+    if (!checkMazeSize(width, height, err)) return false;
     if (!(ifs >> playerX >> playerY)) {
         err = "Failed to read player coordinates";
         return false;
@@ -145,6 +264,147 @@ bool loadGameFromFile(const std::string& filename, GameState& state, std::string
     state.exitY = exitY;
     state.moves = moves;
     state.maze_lines = std::move(maze_lines);
+    state.seeded = false;
+    state.diffs.clear();
 
     return true;
-}
\ No newline at end of file
+}
+
+MappedMazeFile::MappedMazeFile()
+    : base(nullptr), length(0), dataOffset(0), rowLength(0) {}
+
+MappedMazeFile::~MappedMazeFile() {
+    close();
+}
+
+#ifdef _WIN32
+bool MappedMazeFile::open(const std::string& filename, std::string& err) {
+    (void)filename;
+    err = "Memory-mapped maze files are not supported on this platform";
+    return false;
+}
+
+void MappedMazeFile::close() {
+    base = nullptr;
+    length = 0;
+}
+#else
+bool MappedMazeFile::open(const std::string& filename, std::string& err) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        err = "Save file not found: " + filename;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        err = "Save file is empty: " + filename;
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        err = "Failed to memory-map save file: " + filename;
+        return false;
+    }
+    base = static_cast<const char*>(mapped);
+    length = static_cast<size_t>(st.st_size);
+    // Rows are read front to back
+    madvise(mapped, length, MADV_SEQUENTIAL);
+
+    // The header is five short lines; parse it from a small copy
+    std::istringstream iss(std::string(base, std::min<size_t>(length, 512)));
+    GameState h;
+    std::string rest;
+    if (!(iss >> h.difficulty >> h.width >> h.height >> h.playerX >> h.playerY
+              >> h.exitX >> h.exitY >> h.moves) || !std::getline(iss, rest) || iss.eof()) {
+        close();
+        err = "Failed to read save file header";
+        return false;
+    }
+    if (h.width <= 0 || h.height <= 0) {
+        close();
+        err = "Invalid dimensions in save file";
+        return false;
+    }
+    if (!checkMazeSize(h.width, h.height, err)) {
+        close();
+        return false;
+    }
+    if (h.playerX < 0 || h.playerX >= h.width || h.playerY < 0 || h.playerY >= h.height) {
+        close();
+        err = "Player coordinates out of bounds in save file";
+        return false;
+    }
+    if (h.exitX < 0 || h.exitX >= h.width || h.exitY < 0 || h.exitY >= h.height) {
+        close();
+        err = "Exit coordinates out of bounds in save file";
+        return false;
+    }
+
+    dataOffset = static_cast<size_t>(iss.tellg());
+    size_t width = static_cast<size_t>(h.width);
+    // Accept both LF and CRLF line endings, decided by the first row
+    if (dataOffset + width < length && base[dataOffset + width] == '\n') {
+        rowLength = width + 1;
+    } else if (dataOffset + width + 1 < length && base[dataOffset + width] == '\r' &&
+               base[dataOffset + width + 1] == '\n') {
+        rowLength = width + 2;
+    } else {
+        close();
+        err = "Maze line 0 length != width";
+        return false;
+    }
+    if (dataOffset + rowLength * static_cast<size_t>(h.height - 1) + width > length) {
+        close();
+        err = "Not enough maze lines in save file";
+        return false;
+    }
+
+    header = h;
+    return true;
+}
+
+void MappedMazeFile::close() {
+    if (base) munmap(const_cast<char*>(base), length);
+    base = nullptr;
+    length = 0;
+    dataOffset = 0;
+    rowLength = 0;
+}
+#endif
+
+bool loadMazeFromFile(const std::string& filename, GameState& state, MazeGrid& maze, std::string& err) {
+    if (isSeededSave(filename)) {
+        maze.assign(0, 0);
+        return loadGameFromFile(filename, state, err);
+    }
+#ifdef _WIN32
+    if (!loadGameFromFile(filename, state, err)) return false;
+    maze.assign(state.width, state.height);
+    for (int y = 0; y < state.height; ++y) {
+        std::memcpy(maze.row(y), state.maze_lines[y].data(), state.width);
+    }
+    state.maze_lines.clear();
+    return true;
+#else
+    MappedMazeFile file;
+    if (!file.open(filename, err)) return false;
+    state = file.getHeader();
+    maze.assign(state.width, state.height);
+    for (int y = 0; y < state.height; ++y) {
+        const char* line = file.row(y);
+        // Every row but the last must end exactly at width
+        if (y + 1 < state.height && line[state.width] != '\n' && line[state.width] != '\r') {
+            std::ostringstream oss;
+            oss << "Maze line " << y << " length != width (" << state.width << ")";
+            err = oss.str();
+            return false;
+        }
+        std::memcpy(maze.row(y), line, state.width);
+    }
+    return true;
+#endif
+}
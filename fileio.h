@@ -1,8 +1,18 @@
 #ifndef FILEIO_H
 #define FILEIO_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include "maze_grid.h"
+
+// One cell of a seeded save that differs from the regenerated level
+struct CellDiff {
+    int x = 0;
+    int y = 0;
+    char cell = ' ';
+};
 
 struct GameState {
     int difficulty = 1;
@@ -15,13 +25,62 @@ struct GameState {
     int moves = 0;
     // store maze as lines (width characters each)
     std::vector<std::string> maze_lines;
+
+    // Seeded saves store how to rebuild the level instead of maze_lines:
+    // the level seed, carving strategy, tiling and ghost count, plus every
+    // cell of the saved maze (chests as 'C') that differs from the rebuilt one
+    bool seeded = false;
+    std::uint64_t seed = 0;
+    std::string algorithm;
+    int tilesPerSide = 1;
+    int ghostCount = 0;     // 0 = the difficulty's default
+    std::vector<CellDiff> diffs;
 };
 
 // Save the given state to filename. On error, returns false and fills err.
 // Saves atomically by writing to filename + ".tmp" then renaming.
+// A seeded state is written in the compact seeded format, starting with the
+// line "seeded"; otherwise the full maze text is written.
 bool saveGameToFile(const std::string& filename, const GameState& state, std::string& err);
 
-// Load a saved game from filename into state. On error, returns false and fills err.
+// Load a saved game from filename into state, in either format. On error,
+// returns false and fills err.
 bool loadGameFromFile(const std::string& filename, GameState& state, std::string& err);
 
+// Read-only memory map of a save file or streamed maze file. The header is
+// parsed into a GameState (maze_lines stays empty) and rows are served
+// straight from the mapping, so mazes larger than RAM can be read without
+// copying them into strings. Not available on Windows.
+class MappedMazeFile {
+public:
+    MappedMazeFile();
+    ~MappedMazeFile();
+
+    // On error, returns false and fills err
+    bool open(const std::string& filename, std::string& err);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    const GameState& getHeader() const { return header; }
+    // Row y: exactly header.width characters, not NUL-terminated
+    const char* row(int y) const { return base + dataOffset + static_cast<size_t>(y) * rowLength; }
+
+private:
+    MappedMazeFile(const MappedMazeFile&);
+    MappedMazeFile& operator=(const MappedMazeFile&);
+
+    GameState header;
+    const char* base;
+    size_t length;
+    size_t dataOffset;
+    size_t rowLength;   // width plus the line ending
+};
+
+// Load a saved game directly into maze through MappedMazeFile; state only
+// receives the header. Falls back to loadGameFromFile where mapping is
+// unavailable. A seeded save sets state.seeded and leaves maze empty: the
+// caller rebuilds the level from the seed and applies state.diffs.
+// On error, returns false and fills err.
+bool loadMazeFromFile(const std::string& filename, GameState& state, MazeGrid& maze, std::string& err);
+
 #endif // FILEIO_H
\ No newline at end of file
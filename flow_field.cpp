@@ -0,0 +1,79 @@
+#include "flow_field.h"
+
+const std::int32_t FlowField::kUnreachable;
+
+FlowField::FlowField()
+    : width(0), height(0), targetX(-1), targetY(-1), base(0), lastUpdateCells(0) {}
+
+void FlowField::build(const MazeGrid& maze, int x, int y) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    targetX = x;
+    targetY = y;
+    base = 0;
+    stored.assign(maze.cellCount(), kUnreachable);
+    queue.resize(maze.cellCount());
+    lastUpdateCells = 0;
+    if (!maze.inBounds(x, y) || maze(x, y) == '#') return;
+
+    std::uint32_t start = static_cast<std::uint32_t>(maze.index(x, y));
+    stored[start] = 0;
+    queue[0] = start;
+    lastUpdateCells = relax(maze, 1, true);
+}
+
+void FlowField::moveTarget(const MazeGrid& maze, int x, int y) {
+    if (!isBuiltFor(maze) || !maze.inBounds(x, y)) {
+        build(maze, x, y);
+        return;
+    }
+    if (x == targetX && y == targetY) {
+        lastUpdateCells = 0;
+        return;
+    }
+    std::uint32_t start = static_cast<std::uint32_t>(maze.index(x, y));
+    if (stored[start] == kUnreachable) {
+        build(maze, x, y);
+        return;
+    }
+
+    // With the new target k steps from the old one, no cell is more than k
+    // steps farther from it than before, so D + k is an upper bound
+    // everywhere; relaxing from the new target tightens it to the exact
+    // distances
+    const std::int32_t steps = stored[start] + base;
+    base += steps;
+    targetX = x;
+    targetY = y;
+    stored[start] = -base;
+    queue[0] = start;
+    lastUpdateCells = relax(maze, 1, false);
+}
+
+size_t FlowField::relax(const MazeGrid& maze, size_t tail, bool fromScratch) {
+    const char* cells = maze.data();
+    const std::ptrdiff_t stride = maze.getStride();
+    size_t head = 0;
+    while (head < tail) {
+        std::uint32_t cur = queue[head++];
+        std::int32_t next = stored[cur] + 1;
+        int x = static_cast<int>(cur % stride);
+        int y = static_cast<int>(cur / stride);
+        const bool inside[4] = {x > 0, x + 1 < width, y > 0, y + 1 < height};
+        const std::ptrdiff_t offset[4] = {-1, 1, -stride, stride};
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!inside[dir]) continue;
+            std::uint32_t n = static_cast<std::uint32_t>(cur + offset[dir]);
+            if (cells[n] == '#') continue;
+            if (stored[n] == kUnreachable) {
+                // Cut off from the old target means cut off from the new one
+                if (!fromScratch) continue;
+            } else if (stored[n] <= next) {
+                continue;
+            }
+            stored[n] = next;
+            queue[tail++] = n;
+        }
+    }
+    return tail;
+}
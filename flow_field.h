@@ -0,0 +1,61 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+
+// Walking distance from every open cell to one target cell (the player),
+// shared by all hunters: a hunter steps to any neighbour with a smaller
+// distance, which is an O(1) lookup however many hunters there are.
+//
+// When the target moves k steps, no distance grows by more than k. The field
+// adds k to all cells in O(1) through a global offset, then relaxes outward
+// from the new target, only visiting cells that ended up no more than k
+// farther away than before. The result is exact, the same as a fresh BFS.
+// Hunters wake every few ticks, so k is usually a handful of cells.
+class FlowField {
+public:
+    static const std::int32_t kUnreachable = INT32_MAX;
+
+    FlowField();
+
+    // Full BFS from the target cell
+    void build(const MazeGrid& maze, int targetX, int targetY);
+    // Incremental update for a target reachable from the current one,
+    // however far it moved; full rebuild otherwise (a target cut off from
+    // the old one, a different maze)
+    void moveTarget(const MazeGrid& maze, int targetX, int targetY);
+
+    bool isBuiltFor(const MazeGrid& maze) const {
+        return width == maze.getWidth() && height == maze.getHeight() && !stored.empty();
+    }
+    int getTargetX() const { return targetX; }
+    int getTargetY() const { return targetY; }
+
+    // Steps from (x, y) to the target, kUnreachable for walls and cells
+    // cut off from it. Caller guarantees (x, y) is inside the maze.
+    std::int32_t distance(int x, int y) const {
+        std::int32_t s = stored[static_cast<size_t>(y) * width + x];
+        return s == kUnreachable ? kUnreachable : s + base;
+    }
+
+    // Cells written by the most recent build or moveTarget
+    size_t getLastUpdateCells() const { return lastUpdateCells; }
+
+private:
+    int width, height;
+    int targetX, targetY;
+    std::int32_t base;                  // added to every stored distance
+    std::vector<std::int32_t> stored;   // distance - base, or kUnreachable
+    std::vector<std::uint32_t> queue;   // reused BFS queue, one slot per cell
+    size_t lastUpdateCells;
+
+    // BFS from the cells already in queue[0, tail), writing every
+    // improvement; fromScratch also fills cells still marked unreachable.
+    // Returns the number of cells written.
+    size_t relax(const MazeGrid& maze, size_t tail, bool fromScratch);
+};
+
+#endif // FLOW_FIELD_H
@@ -0,0 +1,54 @@
+#include "frame_encoder.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const int FrameEncoder::kStdoutFd;
+
+FrameEncoder::FrameEncoder(size_t capacity) : bytes(capacity), used(0), pen(kNoPen) {
+}
+
+void FrameEncoder::grow(size_t extra) {
+    size_t size = bytes.size() ? bytes.size() : 1;
+    while (size < used + extra) size *= 2;
+    bytes.resize(size);
+}
+
+void FrameEncoder::appendInt(int value) {
+    char digits[12];
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+void FrameEncoder::moveTo(int row, int col) {
+    append("\033[");
+    appendInt(row);
+    append(';');
+    appendInt(col);
+    append('H');
+}
+
+bool FrameEncoder::flush(int fd) const {
+    size_t done = 0;
+    while (done < used) {
+#ifdef _WIN32
+        const unsigned chunk = static_cast<unsigned>(std::min<size_t>(used - done, INT_MAX));
+        const int written = _write(fd, bytes.data() + done, chunk);
+#else
+        const ssize_t written = ::write(fd, bytes.data() + done, used - done);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        done += static_cast<size_t>(written);
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef FRAME_ENCODER_H
+#define FRAME_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Bytes of one terminal frame. The buffer is reserved up front and kept
+// from frame to frame, so once it has grown to the largest frame seen,
+// encoding a frame does not allocate. Colors are set by palette index: the
+// escape code is only written when the index differs from the one the
+// terminal already has. A finished frame goes out in a single write(2)
+// (_write on Windows).
+class FrameEncoder {
+public:
+    static const std::uint32_t kNoPen = UINT32_MAX;
+    // Standard output's descriptor, for POSIX and the Windows C runtime alike
+    static const int kStdoutFd = 1;
+
+    explicit FrameEncoder(size_t capacity = 64 * 1024);
+
+    void clear() {
+        used = 0;
+        pen = kNoPen;
+    }
+    void append(std::string_view text) {
+        if (used + text.size() > bytes.size()) grow(text.size());
+        text.copy(bytes.data() + used, text.size());
+        used += text.size();
+    }
+    void append(char c) {
+        if (used == bytes.size()) grow(1);
+        bytes[used++] = c;
+    }
+    void appendInt(int value);
+    // Cursor to a 1-based row and column
+    void moveTo(int row, int col);
+    // Switch to palette color `color`, whose escape code is `code`
+    void setPen(std::uint32_t color, std::string_view code) {
+        if (color == pen) return;
+        append(code);
+        pen = color;
+    }
+    // For pens whose code is written by the caller: true if `color` is
+    // not the current pen, which it then becomes
+    bool changePen(std::uint32_t color) {
+        if (color == pen) return false;
+        pen = color;
+        return true;
+    }
+    // Attributes were changed without setPen; the next setPen writes its code
+    void resetPen() { pen = kNoPen; }
+    std::uint32_t getPen() const { return pen; }
+
+    size_t size() const { return used; }
+    size_t capacity() const { return bytes.size(); }
+    std::string_view view() const { return std::string_view(bytes.data(), used); }
+    // Writes the frame to fd, retrying on partial writes and EINTR; false
+    // if the descriptor fails
+    bool flush(int fd) const;
+
+private:
+    std::vector<char> bytes;
+    size_t used;
+    std::uint32_t pen;
+
+    void grow(size_t extra);
+};
+
+#endif // FRAME_ENCODER_H
@@ -1,317 +1,608 @@
 #include "ghost.h"
-#include <iostream>
+#include "thread_pool.h"
 #include <algorithm>
-#include <random>
-
-// Ghost class implementation
-Ghost::Ghost(Position startPos, GhostType ghostType, int speed)
-    : position(startPos), previousPosition(startPos), type(ghostType),
-      moveSpeed(speed), moveCounter(0), isActive(true),
-      currentPatrolIndex(0), patrolForward(true) {
+#include <cstdlib>
+
+namespace {
+// Ghosts per move-pass task; smaller batches run on the calling thread
+const size_t kGhostsPerTask = 2048;
+// Longest patrol loop, and the length an out-and-back route grows to
+const std::uint32_t kMaxPatrolLoopCells = 60;
+const size_t kPatrolWalkCells = 24;
+}
 
-    std::random_device rd;
-    gen.seed(rd());
+const int GhostManager::kTickMs;
+const int GhostManager::kLodChunkCells;
+const int GhostManager::kLodFactor;
+const std::uint32_t GhostManager::kNone;
 
-    // Set display character based on ghost type
+char ghostDisplayChar(GhostType type) {
     switch(type) {
-        case RANDOM_WALKER: displayChar = 'G'; break;    // Normal ghost
-        case PATROL_GUARD: displayChar = 'P'; break;     // Patrol ghost
-        case HUNTER: displayChar = 'H'; break;           // Hunter ghost
-        case TELEPORTING: displayChar = 'T'; break;      // Teleporting ghost
-        default: displayChar = 'G';
+        case RANDOM_WALKER: return 'G';    // Normal ghost
+        case PATROL_GUARD: return 'P';     // Patrol ghost
+        case HUNTER: return 'H';           // Hunter ghost
+        case TELEPORTING: return 'T';      // Teleporting ghost
+        default: return 'G';
     }
 }
 
-void Ghost::update(const Position& playerPos, const std::vector<std::vector<char>>& maze,
-                  const std::vector<Position>& chests, const std::vector<Position>& otherGhosts) {
+GhostManager::GhostManager(int gameDifficulty, std::uint64_t seed)
+    : difficulty(gameDifficulty), levelSeed(seed), gen(makeRng(seed, RNG_GHOST_SPAWNS)),
+      clockMs(0), lastDueCount(0), pool(nullptr), tickMaze(nullptr), lodRadius(0), lodChunksX(0), lodChunksY(0),
+      playerChunk(kNone), farCount(0) {}
 
-    // Control update frequency based on move speed
-    moveCounter++;
-    if (moveCounter < moveSpeed / 100) { // Simple speed control
-        return;
-    }
-    moveCounter = 0;
+GhostManager::GhostManager(int gameDifficulty) : GhostManager(gameDifficulty, randomSeed()) {}
 
-    previousPosition = position;
-    Position newPosition = position;
+void GhostManager::initializeGhosts(int mazeWidth, int mazeHeight, const MazeGrid& maze) {
+    initializeGhosts(maze, planGhostSpawns(mazeWidth, mazeHeight, maze));
+}
 
-    // Select movement strategy based on ghost type
-    switch(type) {
-        case RANDOM_WALKER:
-            newPosition = getRandomMove(maze);
-            break;
-        case PATROL_GUARD:
-            newPosition = getPatrolMove();
-            break;
-        case HUNTER:
-            newPosition = getHunterMove(playerPos, maze);
-            break;
-        case TELEPORTING:
-            newPosition = getTeleportingMove(maze);
-            break;
-    }
+std::vector<Position> GhostManager::planGhostSpawns(int mazeWidth, int mazeHeight, const MazeGrid& maze,
+                                                    int ghostCount) {
+    if (!walkable.isBuiltFor(maze)) walkable.build(maze);
+    return planGhostSpawns(walkable, mazeWidth, mazeHeight, ghostCount);
+}
 
-    // Validate if move is valid (no wall collision, no chest overlap, no other ghost overlap)
-    if (isValidMove(newPosition, maze, chests, otherGhosts)) {
-        position = newPosition;
+std::vector<Position> GhostManager::planGhostSpawns(const WalkableIndex& freeCells, int mazeWidth, int mazeHeight,
+                                                    int ghostCount) {
+    if (ghostCount <= 0) ghostCount = defaultGhostCount(difficulty);
+    std::vector<Position> spawns;
+    spawns.reserve(ghostCount);
+    for (int i = 0; i < ghostCount; i++) {
+        spawns.push_back(findValidGhostPosition(freeCells, mazeWidth, mazeHeight));
     }
+    return spawns;
 }
 
-bool Ghost::checkPlayerCollision(const Position& playerPos) const {
-    return position == playerPos;
+void GhostManager::initializeGhosts(const MazeGrid& maze, const std::vector<Position>& spawns) {
+    positions.clear();
+    types.clear();
+    moveIntervals.clear();
+    typeSlots.clear();
+    rngs.clear();
+    lodChunk.clear();
+    lodNext.clear();
+    lodPrev.clear();
+    for (auto& ids : idsByType) ids.clear();
+    patrols.clear();
+    patrolPool.clear();
+    schedule.clear(clockMs);
+    occupancy.reset(maze);
+    neighbors.build(maze);
+    resetLodTables(maze);
+    if (!walkable.isBuiltFor(maze)) walkable.build(maze);
+    if (!corridors.isBuiltFor(maze)) corridors.build(maze);
+
+    int speed = getGhostSpeedForDifficulty();
+    for (int i = 0; i < (int)spawns.size(); i++) {
+        addGhost(maze, spawns[i], getGhostTypeForDifficulty(i), speed);
+    }
 }
 
-Position Ghost::getRandomMove(const std::vector<std::vector<char>>& maze) {
-    std::vector<Position> possibleMoves = getValidAdjacentPositions(position, maze);
-
-    if (possibleMoves.empty()) {
-        return position; // Cannot move, stay in place
+void GhostManager::addGhost(const MazeGrid& maze, Position pos, GhostType type, int speed) {
+    ensureLevelTables(maze);
+    std::uint32_t id = static_cast<std::uint32_t>(positions.size());
+    std::uint32_t interval = static_cast<std::uint32_t>(std::max(1, speed / 100)) * kTickMs;
+    positions.push_back(pos);
+    types.push_back(static_cast<std::uint8_t>(type));
+    moveIntervals.push_back(interval);
+    typeSlots.push_back(static_cast<std::uint32_t>(idsByType[type].size()));
+    rngs.push_back(makeCompactRng(levelSeed, RNG_GHOSTS, id));
+    lodChunk.push_back(kNone);
+    lodNext.push_back(kNone);
+    lodPrev.push_back(kNone);
+    idsByType[type].push_back(id);
+    if (type == PATROL_GUARD) {
+        if (!corridors.isBuiltFor(maze)) corridors.build(maze);
+        patrols.push_back(buildPatrolRoute(pos));
     }
+    occupancy.addGhost(pos.x, pos.y);
+    schedule.schedule(id, clockMs + interval);
+}
+
+void GhostManager::ensureLevelTables(const MazeGrid& maze) {
+    if (occupancy.isSizedFor(maze)) return;
+    occupancy.reset(maze);
+    neighbors.build(maze);
+    if (!walkable.isBuiltFor(maze)) walkable.build(maze);
+    for (const auto& pos : positions) occupancy.addGhost(pos.x, pos.y);
+    resetLodTables(maze);
+}
 
-    std::uniform_int_distribution<> dis(0, possibleMoves.size() - 1);
-    return possibleMoves[dis(gen)];
+void GhostManager::resetLodTables(const MazeGrid& maze) {
+    lodChunksX = (maze.getWidth() + kLodChunkCells - 1) / kLodChunkCells;
+    lodChunksY = (maze.getHeight() + kLodChunkCells - 1) / kLodChunkCells;
+    chunkHeads.assign(static_cast<size_t>(lodChunksX) * lodChunksY, kNone);
+    std::fill(lodChunk.begin(), lodChunk.end(), kNone);
+    playerChunk = kNone;
+    farCount = 0;
 }
 
-Position Ghost::getPatrolMove() {
-    if (patrolPath.empty()) {
-        return position; // No patrol path, stay in place
+GhostManager::PatrolState GhostManager::buildPatrolRoute(const Position& spawn) {
+    PatrolState patrol{static_cast<std::uint32_t>(patrolPool.size()), 0, 0, true, false};
+    std::uint32_t e = corridors.edgeAt(spawn.x, spawn.y);
+    std::uint32_t node;
+    if (e != CorridorGraph::kNone) {
+        node = corridors.edge(e).a;
+    } else {
+        node = corridors.nodeAt(spawn.x, spawn.y);
+        if (node == CorridorGraph::kNone) return patrol; // Inside a wall
+        size_t degree = corridors.edgesEnd(node) - corridors.edgesBegin(node);
+        if (degree == 0) return patrol; // Walled-in cell
+        e = corridors.edgesBegin(node)[std::uniform_int_distribution<size_t>(0, degree - 1)(gen)];
     }
 
-    // Move along patrol path
-    if (patrolForward) {
-        currentPatrolIndex++;
-        if (currentPatrolIndex >= patrolPath.size()) {
-            currentPatrolIndex = patrolPath.size() - 2;
-            patrolForward = false;
-        }
+    std::vector<pos> route;
+    if (corridors.findLoop(node, e, kMaxPatrolLoopCells, route)) {
+        patrol.loop = true;
     } else {
-        currentPatrolIndex--;
-        if (currentPatrolIndex < 0) {
-            currentPatrolIndex = 1;
-            patrolForward = true;
+        // No loop nearby (a tree-like part of the maze): walk on from the
+        // spawn's corridor into random unvisited ones and patrol back and forth
+        std::vector<std::uint32_t> visited(1, node);
+        route.push_back(corridors.nodeCell(node));
+        std::uint32_t at = node;
+        // The spawn's own corridor is always taken, however long
+        while (e != CorridorGraph::kNone &&
+               (route.size() == 1 || route.size() + corridors.edge(e).length <= kMaxPatrolLoopCells)) {
+            corridors.appendEdgeCells(e, at, route);
+            at = corridors.otherEnd(e, at);
+            visited.push_back(at);
+            if (route.size() >= kPatrolWalkCells) break;
+
+            std::uint32_t options[4];
+            size_t optionCount = 0;
+            for (const std::uint32_t* next = corridors.edgesBegin(at); next != corridors.edgesEnd(at); ++next) {
+                std::uint32_t far = corridors.otherEnd(*next, at);
+                if (optionCount < 4 && std::find(visited.begin(), visited.end(), far) == visited.end()) {
+                    options[optionCount++] = *next;
+                }
+            }
+            e = optionCount == 0 ? CorridorGraph::kNone
+                                 : options[std::uniform_int_distribution<size_t>(0, optionCount - 1)(gen)];
         }
     }
 
-    return patrolPath[currentPatrolIndex];
+    for (size_t i = 0; i < route.size(); i++) {
+        if (route[i].x == spawn.x && route[i].y == spawn.y) patrol.index = static_cast<std::int16_t>(i);
+        patrolPool.emplace_back(route[i].x, route[i].y);
+    }
+    patrol.length = static_cast<std::uint16_t>(route.size());
+    if (patrol.length < 2) {
+        patrolPool.resize(patrol.start);
+        patrol.length = 0;
+        patrol.index = 0;
+    }
+    return patrol;
 }
 
-Position Ghost::getHunterMove(const Position& playerPos, const std::vector<std::vector<char>>& maze) {
-    // Calculate Manhattan distance to player
-    int currentDistance = manhattanDistance(position, playerPos);
-
-    // Get all possible move positions
-    std::vector<Position> possibleMoves = getValidAdjacentPositions(position, maze);
-
-    if (possibleMoves.empty()) {
-        return position;
+void GhostManager::setChests(const std::vector<Position>& chests) {
+    for (const auto& chest : chests) {
+        occupancy.setChest(chest.x, chest.y, true);
+        walkable.erase(chest.x, chest.y);
     }
+}
+
+void GhostManager::removeChest(const Position& chest) {
+    occupancy.setChest(chest.x, chest.y, false);
+    walkable.insert(chest.x, chest.y);
+}
 
-    // Find move direction that reduces distance to player
-    std::vector<Position> bestMoves;
-    int bestDistance = currentDistance;
+void GhostManager::updateAllGhosts(const Position& playerPos, const MazeGrid& maze) {
+    advanceTo(clockMs + kTickMs, playerPos, maze);
+}
 
-    for (const auto& move : possibleMoves) {
-        int newDistance = manhattanDistance(move, playerPos);
-        if (newDistance < bestDistance) {
-            bestDistance = newDistance;
-            bestMoves.clear();
-            bestMoves.push_back(move);
-        } else if (newDistance == bestDistance) {
-            bestMoves.push_back(move);
+void GhostManager::advanceTo(std::int64_t nowMs, const Position& playerPos, const MazeGrid& maze) {
+    lastDueCount = 0;
+    if (nowMs < clockMs) return;
+    clockMs = nowMs;
+    if (!occupancy.isSizedFor(maze)) return; // No ghosts placed on this maze
+    occupancy.setPlayer(playerPos.x, playerPos.y);
+    if (lodRadius > 0) {
+        std::uint32_t chunk = chunkOf(playerPos);
+        if (chunk != playerChunk) {
+            updatePlayerChunk(playerChunk, chunk);
+            playerChunk = chunk;
         }
     }
 
-    // If there are better move options, randomly select one
-    if (!bestMoves.empty()) {
-        std::uniform_int_distribution<> dis(0, bestMoves.size() - 1);
-        return bestMoves[dis(gen)];
+    // Slots in time order; only the ghosts due in each are touched
+    while (schedule.popSlot(nowMs, dueGhosts)) {
+        if (dueGhosts.empty()) continue;
+        lastDueCount += dueGhosts.size();
+        moveDueGhosts(playerPos, maze);
     }
-
-    // No better move, randomly select
-    std::uniform_int_distribution<> dis(0, possibleMoves.size() - 1);
-    return possibleMoves[dis(gen)];
 }
 
-Position Ghost::getTeleportingMove(const std::vector<std::vector<char>>& maze) {
-    // 30% chance to teleport, 70% chance to move randomly
-    std::uniform_real_distribution<> probDis(0.0, 1.0);
-
-    if (probDis(gen) < 0.3) { // Teleport
-        std::vector<Position> emptySpaces;
-        int height = maze.size();
-        int width = maze[0].size();
-
-        // Find all empty space positions
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                if (maze[y][x] == ' ') { // Empty space
-                    emptySpaces.emplace_back(x, y);
-                }
+void GhostManager::moveDueGhosts(const Position& playerPos, const MazeGrid& maze) {
+    // Ghosts sharing an interval come back in id order; mixed intervals
+    // can interleave them
+    auto byId = [](const TimingWheel::Entry& a, const TimingWheel::Entry& b) { return a.id < b.id; };
+    if (!std::is_sorted(dueGhosts.begin(), dueGhosts.end(), byId)) {
+        std::sort(dueGhosts.begin(), dueGhosts.end(), byId);
+    }
+
+    // One field for all hunters. The player has usually moved a few cells
+    // since the last hunter woke, which is an incremental relax rather than a
+    // new BFS. Far hunters only need to head the right way, so on their own
+    // they make do with a field up to a chunk out of date.
+    bool nearHunterDue = false, farHunterDue = false;
+    for (const auto& entry : dueGhosts) {
+        if (types[entry.id] != HUNTER) continue;
+        if (lodChunk[entry.id] == kNone) {
+            nearHunterDue = true;
+            break;
+        }
+        farHunterDue = true;
+    }
+    const int fieldLag = std::abs(playerField.getTargetX() - playerPos.x) +
+                         std::abs(playerField.getTargetY() - playerPos.y);
+    if ((nearHunterDue && fieldLag > 0) || (farHunterDue && fieldLag >= kLodChunkCells) ||
+        ((nearHunterDue || farHunterDue) && !playerField.isBuiltFor(maze))) {
+        playerField.moveTarget(maze, playerPos.x, playerPos.y);
+    }
+
+    // Move pass: every ghost reads only the positions and occupancy from
+    // before this slot
+    const size_t n = dueGhosts.size();
+    plannedMoves.resize(n);
+    tickMaze = &maze;
+    if (pool && n > kGhostsPerTask) {
+        int tasks = static_cast<int>((n + kGhostsPerTask - 1) / kGhostsPerTask);
+        pool->parallelFor(tasks, [this](int task) { planMoveTask(task); });
+    } else {
+        planMoves(0, n);
+    }
+    tickMaze = nullptr;
+
+    // Conflict pass in id order. Wanted cells were free before the slot, so
+    // a ghost already on one got there in this slot with a lower id: stay put.
+    for (size_t k = 0; k < n; k++) {
+        std::uint32_t id = dueGhosts[k].id;
+        Position from = positions[id];
+        Position to = plannedMoves[k];
+        const bool wasFar = lodChunk[id] != kNone;
+        if (to != from && !occupancy.hasGhost(to.x, to.y)) {
+            occupancy.moveGhost(from.x, from.y, to.x, to.y);
+            positions[id] = to;
+            if (types[id] == PATROL_GUARD) {
+                PatrolState& patrol = patrols[typeSlots[id]];
+                patrol = wasFar ? advancePatrol(patrol, kLodFactor) : nextPatrolStep(patrol);
             }
         }
 
-        if (!emptySpaces.empty()) {
-            std::uniform_int_distribution<> dis(0, emptySpaces.size() - 1);
-            return emptySpaces[dis(gen)];
+        // Near or far from where the ghost ended up
+        std::uint32_t chunk = lodRadius > 0 ? chunkOf(positions[id]) : kNone;
+        bool far = chunk != kNone && !inLodRange(chunk, playerChunk);
+        if (lodChunk[id] != (far ? chunk : kNone)) {
+            if (wasFar) unlinkFar(id);
+            if (far) linkFar(id, chunk);
         }
+        schedule.schedule(id, dueGhosts[k].dueMs + moveIntervals[id] * (far ? kLodFactor : 1));
     }
+}
 
-    // Normal random move
-    return getRandomMove(maze);
+void GhostManager::setLodRadius(int radius) {
+    radius = std::max(0, radius);
+    if (radius == lodRadius) return;
+    // Every far ghost back on its exact cadence; the next advance sorts
+    // them out again
+    for (std::uint32_t chunk = 0; chunk < chunkHeads.size(); chunk++) promoteChunk(chunk);
+    lodRadius = radius;
+    playerChunk = kNone;
 }
 
-bool Ghost::isValidMove(const Position& newPos, const std::vector<std::vector<char>>& maze,
-                       const std::vector<Position>& chests, const std::vector<Position>& otherGhosts) const {
+bool GhostManager::inLodRange(std::uint32_t chunk, std::uint32_t center) const {
+    int dx = static_cast<int>(chunk % lodChunksX) - static_cast<int>(center % lodChunksX);
+    int dy = static_cast<int>(chunk / lodChunksX) - static_cast<int>(center / lodChunksX);
+    return std::abs(dx) <= lodRadius && std::abs(dy) <= lodRadius;
+}
 
-    // Check boundaries
-    if (newPos.x < 0 || newPos.x >= maze[0].size() || newPos.y < 0 || newPos.y >= maze.size()) {
-        return false;
+void GhostManager::linkFar(std::uint32_t id, std::uint32_t chunk) {
+    lodChunk[id] = chunk;
+    lodPrev[id] = kNone;
+    lodNext[id] = chunkHeads[chunk];
+    if (chunkHeads[chunk] != kNone) lodPrev[chunkHeads[chunk]] = id;
+    chunkHeads[chunk] = id;
+    farCount++;
+}
+
+void GhostManager::unlinkFar(std::uint32_t id) {
+    if (lodPrev[id] == kNone) {
+        chunkHeads[lodChunk[id]] = lodNext[id];
+    } else {
+        lodNext[lodPrev[id]] = lodNext[id];
     }
+    if (lodNext[id] != kNone) lodPrev[lodNext[id]] = lodPrev[id];
+    lodChunk[id] = kNone;
+    farCount--;
+}
 
-    // Check if it's a wall
-    if (maze[newPos.y][newPos.x] == '#') {
-        return false;
+void GhostManager::promoteChunk(std::uint32_t chunk) {
+    for (std::uint32_t id = chunkHeads[chunk]; id != kNone;) {
+        std::uint32_t following = lodNext[id];
+        unlinkFar(id);
+        // First exact move time after now, counted from its last wake
+        const std::int64_t interval = moveIntervals[id];
+        const std::int64_t due = schedule.getDueMs(id);
+        const std::int64_t lastWake = due - interval * kLodFactor;
+        const std::int64_t exact = lastWake + interval * ((clockMs - lastWake) / interval + 1);
+        schedule.reschedule(id, std::min(due, exact));
+        id = following;
     }
+}
 
-    // Check if overlapping with chest
-    for (const auto& chest : chests) {
-        if (newPos == chest) {
-            return false;
+void GhostManager::updatePlayerChunk(std::uint32_t from, std::uint32_t to) {
+    // Only the chunks that just came into range can hold far ghosts that
+    // are near now
+    const int cx = static_cast<int>(to % lodChunksX), cy = static_cast<int>(to / lodChunksX);
+    for (int y = std::max(0, cy - lodRadius); y <= std::min(lodChunksY - 1, cy + lodRadius); y++) {
+        for (int x = std::max(0, cx - lodRadius); x <= std::min(lodChunksX - 1, cx + lodRadius); x++) {
+            std::uint32_t chunk = static_cast<std::uint32_t>(y * lodChunksX + x);
+            if (from == kNone || !inLodRange(chunk, from)) promoteChunk(chunk);
         }
     }
+}
+
+void GhostManager::planMoveTask(int task) {
+    size_t begin = static_cast<size_t>(task) * kGhostsPerTask;
+    planMoves(begin, std::min(dueGhosts.size(), begin + kGhostsPerTask));
+}
 
-    // Check if overlapping with other ghosts (except own previous position)
-    for (const auto& otherGhost : otherGhosts) {
-        if (newPos == otherGhost && newPos != previousPosition) {
-            return false;
+void GhostManager::planMoves(size_t begin, size_t end) {
+    for (size_t k = begin; k < end; k++) {
+        std::uint32_t id = dueGhosts[k].id;
+        Position from = positions[id];
+        Position target = from;
+        if (lodChunk[id] != kNone) {
+            target = getFarMove(id);
+        } else {
+            switch (types[id]) {
+                case RANDOM_WALKER: target = getRandomMove(id); break;
+                case PATROL_GUARD: target = getPatrolMove(id, patrols[typeSlots[id]]); break;
+                case HUNTER: target = getHunterMove(id); break;
+                case TELEPORTING: target = getTeleportingMove(id); break;
+            }
         }
+        // Validate if move is valid (no wall collision, no chest overlap, no other ghost overlap)
+        if (target != from && !isValidMove(from, target, *tickMaze)) target = from;
+        plannedMoves[k] = target;
     }
-
-    return true;
 }
 
-int Ghost::manhattanDistance(const Position& a, const Position& b) const {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+Position GhostManager::getRandomMove(std::uint32_t id) {
+    Position position = positions[id];
+    const NeighborMasks::DirectionList& possibleMoves =
+        NeighborMasks::directions(neighbors.mask(position.x, position.y));
+
+    if (possibleMoves.count == 0) {
+        return position; // Cannot move, stay in place
+    }
+
+    int dir = possibleMoves.dirs[rngs[id].below(possibleMoves.count)];
+    return Position(position.x + NeighborMasks::kDx[dir], position.y + NeighborMasks::kDy[dir]);
 }
 
-std::vector<Position> Ghost::getValidAdjacentPositions(const Position& current,
-                                                      const std::vector<std::vector<char>>& maze) const {
-    std::vector<Position> validPositions;
-    std::vector<Position> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}}; // Up, down, left, right
+Position GhostManager::getPatrolMove(std::uint32_t id, PatrolState& patrol) {
+    if (patrol.length == 0) {
+        return positions[id]; // No patrol path, stay in place
+    }
 
-    for (const auto& dir : directions) {
-        Position newPos(current.x + dir.x, current.y + dir.y);
+    // Next cell on the route; the step is taken in the conflict pass once
+    // the move goes through. A chest on the route turns the guard around.
+    Position target = patrolPool[patrol.start + nextPatrolStep(patrol).index];
+    if (occupancy.hasChest(target.x, target.y)) {
+        patrol.forward = !patrol.forward;
+        target = patrolPool[patrol.start + nextPatrolStep(patrol).index];
+    }
+    return target;
+}
 
-        // Simple check: not out of bounds and not a wall
-        if (newPos.x >= 0 && newPos.x < maze[0].size() &&
-            newPos.y >= 0 && newPos.y < maze.size() &&
-            maze[newPos.y][newPos.x] != '#') {
-            validPositions.push_back(newPos);
+GhostManager::PatrolState GhostManager::nextPatrolStep(const PatrolState& patrol) {
+    PatrolState next = patrol;
+    if (patrol.loop) {
+        next.index = static_cast<std::int16_t>(patrol.forward ? (patrol.index + 1) % patrol.length
+                                                              : (patrol.index + patrol.length - 1) % patrol.length);
+    } else if (patrol.forward) {
+        next.index++;
+        if (next.index >= patrol.length) {
+            next.index = patrol.length - 2;
+            next.forward = false;
+        }
+    } else {
+        next.index--;
+        if (next.index < 0) {
+            next.index = 1;
+            next.forward = true;
         }
     }
+    return next;
+}
 
-    return validPositions;
+GhostManager::PatrolState GhostManager::advancePatrol(const PatrolState& patrol, int steps) {
+    PatrolState next = patrol;
+    if (patrol.length < 2) return next;
+    if (patrol.loop) {
+        int shift = steps % patrol.length;
+        if (!patrol.forward) shift = patrol.length - shift;
+        next.index = static_cast<std::int16_t>((patrol.index + shift) % patrol.length);
+        return next;
+    }
+    // Out and back: phase p of a 2 * (length - 1) cycle is index p going
+    // forward below length - 1, index 2 * (length - 1) - p coming back
+    const int last = patrol.length - 1;
+    const int period = 2 * last;
+    int phase = ((patrol.forward ? patrol.index : period - patrol.index) + steps) % period;
+    next.forward = phase < last;
+    next.index = static_cast<std::int16_t>(next.forward ? phase : period - phase);
+    return next;
 }
 
-void Ghost::setPatrolPath(const std::vector<Position>& path) {
-    patrolPath = path;
-    if (!patrolPath.empty()) {
-        position = patrolPath[0];
-        currentPatrolIndex = 0;
-        patrolForward = true;
+Position GhostManager::getHunterMove(std::uint32_t id) {
+    // Step to a neighbour that is closer to the player by walking distance
+    Position position = positions[id];
+    if (playerField.distance(position.x, position.y) == FlowField::kUnreachable) {
+        return getRandomMove(id); // Cut off from the player, wander
     }
+    return getHunterStep(id, position);
 }
 
-// GhostManager class implementation
-GhostManager::GhostManager(int gameDifficulty) : difficulty(gameDifficulty) {
-    std::random_device rd;
-    gen.seed(rd());
+Position GhostManager::getHunterStep(std::uint32_t id, const Position& position) {
+    int currentDistance = playerField.distance(position.x, position.y);
+    Position bestMoves[4];
+    int bestCount = 0;
+    const NeighborMasks::DirectionList& open =
+        NeighborMasks::directions(neighbors.mask(position.x, position.y));
+    for (int i = 0; i < open.count; i++) {
+        int nx = position.x + NeighborMasks::kDx[open.dirs[i]];
+        int ny = position.y + NeighborMasks::kDy[open.dirs[i]];
+        if (playerField.distance(nx, ny) < currentDistance) {
+            bestMoves[bestCount++] = Position(nx, ny);
+        }
+    }
+
+    if (bestCount == 0) {
+        return position; // Already on the player
+    }
+
+    // Several shortest routes: randomly select one
+    return bestMoves[rngs[id].below(bestCount)];
 }
 
-void GhostManager::initializeGhosts(int mazeWidth, int mazeHeight, const std::vector<std::vector<char>>& maze) {
-    ghosts.clear();
-    int ghostCount = getGhostCountForDifficulty();
+Position GhostManager::getTeleportingMove(std::uint32_t id) {
+    // 30% chance to teleport, 70% chance to move randomly
+    const std::uint32_t teleportBelow = static_cast<std::uint32_t>(0.3 * 4294967296.0);
 
-    for (int i = 0; i < ghostCount; i++) {
-        Position ghostPos = findValidGhostPosition(mazeWidth, mazeHeight, maze);
-        GhostType type = getGhostTypeForDifficulty(i);
-        int speed = 0;
-
-        // Set speed based on difficulty
-        switch(difficulty) {
-            case 1: speed = 500; break; // Easy: slow
-            case 2: speed = 300; break; // Medium: medium speed
-            case 3: speed = 150; break; // Hard: fast
-            default: speed = 300;
-        }
+    if (rngs[id].next() < teleportBelow && !walkable.empty()) { // Teleport to any free cell
+        pos target = walkable.at(rngs[id].below(static_cast<std::uint32_t>(walkable.size())));
+        return Position(target.x, target.y);
+    }
 
-        Ghost ghost(ghostPos, type, speed);
+    // Normal random move
+    return getRandomMove(id);
+}
 
-        // Set patrol path for patrol ghost
-        if (type == PATROL_GUARD) {
-            std::vector<Position> patrolPath;
-            // Simple straight-line patrol path example, can be more complex in practice
-            for (int x = ghostPos.x - 2; x <= ghostPos.x + 2; x += 2) {
-                if (x >= 1 && x < mazeWidth - 1 && maze[ghostPos.y][x] != '#') {
-                    patrolPath.emplace_back(x, ghostPos.y);
-                }
+Position GhostManager::getFarMove(std::uint32_t id) {
+    const Position from = positions[id];
+    switch (types[id]) {
+        case PATROL_GUARD: {
+            // kLodFactor steps along the route at once; a chest where the
+            // guard would land turns it around
+            PatrolState& patrol = patrols[typeSlots[id]];
+            if (patrol.length == 0) return from;
+            Position target = patrolPool[patrol.start + advancePatrol(patrol, kLodFactor).index];
+            if (occupancy.hasChest(target.x, target.y)) {
+                patrol.forward = !patrol.forward;
+                return from;
             }
-            if (patrolPath.size() > 1) {
-                ghost.setPatrolPath(patrolPath);
+            return target;
+        }
+        case HUNTER: {
+            // Up to kLodFactor steps down the flow field, stopping short of
+            // chests and other ghosts
+            if (playerField.distance(from.x, from.y) == FlowField::kUnreachable) return getRandomMove(id);
+            Position at = from;
+            for (int step = 0; step < kLodFactor; step++) {
+                Position next = getHunterStep(id, at);
+                if (next == at || occupancy.hasChest(next.x, next.y) || occupancy.hasGhost(next.x, next.y)) break;
+                at = next;
             }
+            return at;
         }
-
-        ghosts.push_back(ghost);
+        case TELEPORTING:
+            return getTeleportingMove(id);
+        default:
+            return getRandomMove(id);
     }
 }
 
-void GhostManager::updateAllGhosts(const Position& playerPos, const std::vector<std::vector<char>>& maze,
-                                  const std::vector<Position>& chests) {
-    // Collect current positions of all ghosts (for overlap check)
-    std::vector<Position> otherGhostsPositions;
-    for (const auto& ghost : ghosts) {
-        otherGhostsPositions.push_back(ghost.getPosition());
+bool GhostManager::isValidMove(const Position& from, const Position& newPos, const MazeGrid& maze) const {
+    // Check boundaries
+    if (!maze.inBounds(newPos.x, newPos.y)) {
+        return false;
     }
 
-    // Update each ghost
-    for (auto& ghost : ghosts) {
-        ghost.update(playerPos, maze, chests, otherGhostsPositions);
+    // Check if it's a wall
+    if (maze(newPos.x, newPos.y) == '#') {
+        return false;
     }
+
+    // Check if overlapping with chest
+    if (occupancy.hasChest(newPos.x, newPos.y)) {
+        return false;
+    }
+
+    // Check if overlapping with other ghosts (except own position)
+    if (occupancy.hasGhost(newPos.x, newPos.y) && newPos != from) {
+        return false;
+    }
+
+    return true;
 }
 
 bool GhostManager::checkAnyGhostCollision(const Position& playerPos) const {
-    for (const auto& ghost : ghosts) {
-        if (ghost.checkPlayerCollision(playerPos)) {
-            return true;
-        }
-    }
-    return false;
+    if (positions.empty()) return false;
+    return occupancy.hasGhost(playerPos.x, playerPos.y);
+}
+
+std::vector<Position> GhostManager::getPatrolRoute(int id) const {
+    if (types[id] != PATROL_GUARD) return std::vector<Position>();
+    const PatrolState& patrol = patrols[typeSlots[id]];
+    return std::vector<Position>(patrolPool.begin() + patrol.start,
+                                 patrolPool.begin() + patrol.start + patrol.length);
+}
+
+bool GhostManager::isPatrolLoop(int id) const {
+    return types[id] == PATROL_GUARD && patrols[typeSlots[id]].loop;
+}
+
+size_t GhostManager::ghostMemoryBytes() const {
+    size_t bytes = positions.capacity() * sizeof(Position) +
+                   types.capacity() * sizeof(std::uint8_t) +
+                   moveIntervals.capacity() * sizeof(std::uint32_t) +
+                   typeSlots.capacity() * sizeof(std::uint32_t) +
+                   rngs.capacity() * sizeof(CompactRng) +
+                   schedule.memoryBytes() +
+                   dueGhosts.capacity() * sizeof(TimingWheel::Entry) +
+                   plannedMoves.capacity() * sizeof(Position) +
+                   patrols.capacity() * sizeof(PatrolState) +
+                   patrolPool.capacity() * sizeof(Position) +
+                   (lodChunk.capacity() + lodNext.capacity() + lodPrev.capacity() + chunkHeads.capacity()) *
+                       sizeof(std::uint32_t);
+    for (const auto& ids : idsByType) bytes += ids.capacity() * sizeof(std::uint32_t);
+    return bytes;
 }
 
 void GhostManager::setDifficulty(int newDifficulty) {
     difficulty = newDifficulty;
 }
 
-Position GhostManager::findValidGhostPosition(int mazeWidth, int mazeHeight, const std::vector<std::vector<char>>& maze) {
-    std::vector<Position> validPositions;
-
-    // Find all valid ghost positions (empty space and far from player spawn point)
-    for (int y = 1; y < mazeHeight - 1; y++) {
-        for (int x = 1; x < mazeWidth - 1; x++) {
-            if (maze[y][x] == ' ' && // Empty space
-                (x > 3 || y > 3)) {  // Far from starting point (1,1)
-                validPositions.emplace_back(x, y);
+Position GhostManager::findValidGhostPosition(const WalkableIndex& freeCells, int mazeWidth, int mazeHeight) {
+    // Draw free cells until one is inside the border and far from the
+    // player spawn point (1,1); almost every cell qualifies, so this
+    // rarely takes more than one draw
+    if (!freeCells.empty()) {
+        for (int attempt = 0; attempt < 64; attempt++) {
+            pos p = freeCells.sample(gen);
+            if (p.x >= 1 && p.x < mazeWidth - 1 && p.y >= 1 && p.y < mazeHeight - 1 &&
+                (p.x > 3 || p.y > 3)) {
+                return Position(p.x, p.y);
             }
         }
     }
 
-    if (!validPositions.empty()) {
-        std::uniform_int_distribution<> dis(0, validPositions.size() - 1);
-        return validPositions[dis(gen)];
+    // Tiny mazes may have no cell that far: take the free cell farthest
+    // from the player spawn point, never the spawn point itself
+    Position best(mazeWidth / 2, mazeHeight / 2);
+    int bestDistance = 0;
+    for (size_t i = 0; i < freeCells.size(); i++) {
+        pos p = freeCells.at(i);
+        int distance = (p.x - 1) + (p.y - 1);
+        if (distance > bestDistance) {
+            best = Position(p.x, p.y);
+            bestDistance = distance;
+        }
     }
-
-    // If no suitable position found, return a default position
-    return Position(mazeWidth / 2, mazeHeight / 2);
+    return best;
 }
 
 GhostType GhostManager::getGhostTypeForDifficulty(int ghostIndex) const {
@@ -341,11 +632,21 @@ GhostType GhostManager::getGhostTypeForDifficulty(int ghostIndex) const {
     }
 }
 
-int GhostManager::getGhostCountForDifficulty() const {
+int GhostManager::getGhostSpeedForDifficulty() const {
+    // Set speed based on difficulty
+    switch(difficulty) {
+        case 1: return 500; // Easy: slow
+        case 2: return 300; // Medium: medium speed
+        case 3: return 150; // Hard: fast
+        default: return 300;
+    }
+}
+
+int GhostManager::defaultGhostCount(int difficulty) {
     switch(difficulty) {
         case 1: return 1; // Easy: 1 ghost
         case 2: return 3; // Medium: 3 ghosts
         case 3: return 5; // Hard: 5 ghosts
         default: return 2;
     }
-}
\ No newline at end of file
+}
@@ -1,10 +1,21 @@
 #ifndef GHOST_H
 #define GHOST_H
 
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 #include <random>
-#include <chrono>
-#include <thread>
+#include "maze_grid.h"
+#include "flow_field.h"
+#include "occupancy_grid.h"
+#include "walkable_index.h"
+#include "neighbor_masks.h"
+#include "corridor_graph.h"
+#include "rng.h"
+#include "timing_wheel.h"
+
+class ThreadPool;
 
 // Position struct, consistent with other parts of the project
 struct Position {
@@ -24,87 +35,217 @@ enum GhostType {
     RANDOM_WALKER,    // Random walker ghost
     PATROL_GUARD,     // Patrol guard ghost
     HUNTER,           // Hunter ghost
-    TELEPORTING       // Teleporting ghost
+    TELEPORTING,      // Teleporting ghost
+    GHOST_TYPE_COUNT
 };
 
-class Ghost {
-private:
-    Position position;
-    Position previousPosition; // Previous position (for movement trace)
-    GhostType type;
-    int moveSpeed;    // Move speed (milliseconds)
-    int moveCounter;  // Move counter
-    bool isActive;
-    char displayChar; // Display character
-    
-    // Movement related
-    std::vector<Position> patrolPath; // Patrol path (only valid for PATROL_GUARD)
-    int currentPatrolIndex;
-    bool patrolForward; // Patrol direction
-    
-    // Random number generator
-    std::mt19937 gen;
-    
-public:
-    // Constructor
-    Ghost(Position startPos, GhostType ghostType, int speed);
-    
-    // Core functionality methods
-    void update(const Position& playerPos, const std::vector<std::vector<char>>& maze, 
-                const std::vector<Position>& chests, const std::vector<Position>& otherGhosts);
-    bool checkPlayerCollision(const Position& playerPos) const;
-    
-    // Getter methods
-    Position getPosition() const { return position; }
-    GhostType getType() const { return type; }
-    char getDisplayChar() const { return displayChar; }
-    bool getIsActive() const { return isActive; }
-    
-    // Setter methods
-    void setPosition(Position newPos) { position = newPos; }
-    void setPatrolPath(const std::vector<Position>& path);
-    
-private:
-    // Movement strategy methods
-    Position getRandomMove(const std::vector<std::vector<char>>& maze);
-    Position getPatrolMove();
-    Position getHunterMove(const Position& playerPos, const std::vector<std::vector<char>>& maze);
-    Position getTeleportingMove(const std::vector<std::vector<char>>& maze);
-    
-    // Helper methods
-    bool isValidMove(const Position& newPos, const std::vector<std::vector<char>>& maze, 
-                    const std::vector<Position>& chests, const std::vector<Position>& otherGhosts) const;
-    int manhattanDistance(const Position& a, const Position& b) const;
-    std::vector<Position> getValidAdjacentPositions(const Position& current, 
-                                                   const std::vector<std::vector<char>>& maze) const;
-};
+// Display character for a ghost type
+char ghostDisplayChar(GhostType type);
 
+// All ghosts of a level, kept as parallel arrays indexed by ghost id
+// (structure of arrays): positions, types, move intervals and 8-byte RNG
+// states each live in their own dense vector, and patrol routes share one
+// pool, so the per-ghost cost stays flat from a handful of ghosts to 100k.
+//
+// Ghosts move on game time. Each one sits in a timing wheel under the time
+// of its next move, and advancing the clock only wakes the ghosts that are
+// due: a ghost that moves every 2.5 s costs nothing in between, and how
+// often the game calls in does not change how fast ghosts move.
+//
+// The ghosts due in one wheel slot move together. Every one picks its move
+// from the positions and occupancy before the slot into plannedMoves; that
+// pass can be split across a thread pool since ghosts only touch their own
+// state. A serial pass then settles conflicts by ghost id (the lowest id
+// gets a contested cell, the others stay), so the result is the same for
+// any thread count.
+//
+// With a level-of-detail radius set, ghosts more than that many chunks of
+// kLodChunkCells from the player's chunk are far and wake only every
+// kLodFactor moves, covering that many moves at once: patrol guards jump
+// along their route in closed form, hunters walk several steps down the
+// flow field, walkers and teleporters make one move. A far move follows
+// the same rules as a near one for the cell it ends on (no wall, chest or
+// other ghost), and the cells in between are not checked. Far ghosts are
+// listed by chunk, so when the player enters a new chunk the ones now in
+// range are found without a scan and rescheduled on their exact cadence.
 class GhostManager {
 private:
-    std::vector<Ghost> ghosts;
+    // Route of one PATROL_GUARD: patrolPool[start, start + length), a
+    // closed loop or a path walked back and forth
+    struct PatrolState {
+        std::uint32_t start;
+        std::uint16_t length;
+        std::int16_t index;     // current step on the route
+        bool forward;
+        bool loop;
+    };
+
+    // Per ghost, indexed by ghost id
+    std::vector<Position> positions;
+    std::vector<std::uint8_t> types;
+    std::vector<std::uint32_t> moveIntervals;  // game ms between moves
+    std::vector<std::uint32_t> typeSlots;      // index in idsByType[type]
+    std::vector<CompactRng> rngs;              // movement, from RNG_GHOSTS
+    // Ghost ids of each type
+    std::vector<std::uint32_t> idsByType[GHOST_TYPE_COUNT];
+    // Parallel to idsByType[PATROL_GUARD]
+    std::vector<PatrolState> patrols;
+    std::vector<Position> patrolPool;
+
     int difficulty;
+    std::uint64_t levelSeed;
     std::mt19937 gen;
-    
+    // Walking distance to the player, shared by every hunter; only kept up
+    // to date while there are hunters
+    FlowField playerField;
+    // Ghosts, chests and the player by cell
+    OccupancyGrid occupancy;
+    // Free floor cells, for spawns and teleports
+    WalkableIndex walkable;
+    // Open-neighbour masks of the maze the ghosts are on
+    NeighborMasks neighbors;
+    // Junctions and corridors, for patrol routes
+    CorridorGraph corridors;
+    // Next move of every ghost, by game time
+    TimingWheel schedule;
+    std::int64_t clockMs;                      // game time reached so far
+    size_t lastDueCount;
+    // Ghosts of the slot in progress, sorted by id, and their moves
+    std::vector<TimingWheel::Entry> dueGhosts;
+    std::vector<Position> plannedMoves;
+    // Optional workers for the move pass (not owned)
+    ThreadPool* pool;
+    const MazeGrid* tickMaze;                  // maze of the slot in progress
+
+    // Level of detail; off while lodRadius is 0
+    int lodRadius;                             // in chunks, Chebyshev distance
+    int lodChunksX, lodChunksY;
+    std::uint32_t playerChunk;
+    std::vector<std::uint32_t> lodChunk;       // per ghost: its chunk while far, kNone while near
+    std::vector<std::uint32_t> lodNext;        // per ghost: far ghosts of the same chunk
+    std::vector<std::uint32_t> lodPrev;
+    std::vector<std::uint32_t> chunkHeads;     // first far ghost of each chunk, or kNone
+    size_t farCount;
+
 public:
-    GhostManager(int gameDifficulty);
-    
+    // Game time per speed step: a ghost of speed s moves every
+    // max(1, s / 100) * kTickMs ms
+    static const int kTickMs = 500;
+    // Level of detail: chunk size in cells, and the moves a far ghost
+    // covers per wake
+    static const int kLodChunkCells = 32;
+    static const int kLodFactor = 8;
+
+    // Spawns and ghost movement come from streams of levelSeed
+    GhostManager(int gameDifficulty, std::uint64_t levelSeed);
+    // With a fresh random seed
+    explicit GhostManager(int gameDifficulty);
+
     // Ghost group management methods
-    void initializeGhosts(int mazeWidth, int mazeHeight, const std::vector<std::vector<char>>& maze);
-    void updateAllGhosts(const Position& playerPos, const std::vector<std::vector<char>>& maze, 
-                        const std::vector<Position>& chests);
+    void initializeGhosts(int mazeWidth, int mazeHeight, const MazeGrid& maze);
+    // Spawn positions, one per ghost: ghostCount of them, or the difficulty's
+    // default count when ghostCount is 0; can run off the game thread
+    std::vector<Position> planGhostSpawns(int mazeWidth, int mazeHeight, const MazeGrid& maze,
+                                          int ghostCount = 0);
+    std::vector<Position> planGhostSpawns(const WalkableIndex& freeCells, int mazeWidth, int mazeHeight,
+                                          int ghostCount = 0);
+    // Create ghosts at previously planned spawn positions
+    void initializeGhosts(const MazeGrid& maze, const std::vector<Position>& spawns);
+    // Run every ghost move due up to game time nowMs (ms since the ghosts
+    // were initialized); earlier times are ignored
+    void advanceTo(std::int64_t nowMs, const Position& playerPos, const MazeGrid& maze);
+    // Advance the clock by one kTickMs
+    void updateAllGhosts(const Position& playerPos, const MazeGrid& maze);
+    // Add one ghost outside the difficulty plan (benchmarks, scripted levels)
+    void addGhost(const MazeGrid& maze, Position pos, GhostType type, int speed);
+    // Chests block ghosts; mark them after initializeGhosts and clear each
+    // one as it is collected
+    void setChests(const std::vector<Position>& chests);
+    void removeChest(const Position& chest);
+    // Use a prebuilt index of the level's free cells (see Level::walkable);
+    // otherwise one is built from the maze when ghosts are initialized
+    void setWalkable(WalkableIndex index) { walkable = std::move(index); }
+    // Likewise for the corridor graph (see Level::corridors)
+    void setCorridors(CorridorGraph graph) { corridors = std::move(graph); }
+    // Spread the move pass of large swarms over threadPool (nullptr: run
+    // on the calling thread); results do not depend on it
+    void setThreadPool(ThreadPool* threadPool) { pool = threadPool; }
+    // Ghosts more than radius chunks from the player move at the coarse
+    // rate; 0 (the default) keeps every ghost exact
+    void setLodRadius(int radius);
+    int getLodRadius() const { return lodRadius; }
+    size_t getFarGhostCount() const { return farCount; }
+    bool isGhostFar(int id) const { return lodChunk[id] != kNone; }
     bool checkAnyGhostCollision(const Position& playerPos) const;
-    
+
     // Getter methods
-    const std::vector<Ghost>& getGhosts() const { return ghosts; }
-    int getGhostCount() const { return ghosts.size(); }
-    
+    int getGhostCount() const { return static_cast<int>(positions.size()); }
+    std::int64_t getClockMs() const { return clockMs; }
+    // Ghosts woken by the most recent advance, moved or blocked
+    size_t getLastDueCount() const { return lastDueCount; }
+    const std::vector<Position>& getPositions() const { return positions; }
+    Position getGhostPosition(int id) const { return positions[id]; }
+    GhostType getGhostType(int id) const { return static_cast<GhostType>(types[id]); }
+    const FlowField& getPlayerField() const { return playerField; }
+    const OccupancyGrid& getOccupancy() const { return occupancy; }
+    const WalkableIndex& getWalkable() const { return walkable; }
+    const CorridorGraph& getCorridors() const { return corridors; }
+    // Route cells of patrol guard id, in walking order (empty if it has none)
+    std::vector<Position> getPatrolRoute(int id) const;
+    bool isPatrolLoop(int id) const;
+    // Bytes held by the per-ghost arrays, the schedule and the patrol pool
+    size_t ghostMemoryBytes() const;
+
     // Difficulty-related methods
     void setDifficulty(int newDifficulty);
-    
+    static int defaultGhostCount(int difficulty);
+
 private:
-    Position findValidGhostPosition(int mazeWidth, int mazeHeight, const std::vector<std::vector<char>>& maze);
+    static const std::uint32_t kNone = UINT32_MAX;
+
+    // Movement strategies for ghost id; return the cell the ghost wants
+    Position getRandomMove(std::uint32_t id);
+    Position getPatrolMove(std::uint32_t id, PatrolState& patrol);
+    // Route step after patrol's current one
+    static PatrolState nextPatrolStep(const PatrolState& patrol);
+    // Route state steps moves after patrol's, ignoring chests
+    static PatrolState advancePatrol(const PatrolState& patrol, int steps);
+    // Loop through the corridor at spawn if there is a short one, otherwise
+    // a walk along corridors from it; appended to patrolPool
+    PatrolState buildPatrolRoute(const Position& spawn);
+    Position getHunterMove(std::uint32_t id);
+    // Neighbour of from closer to the player, or from if there is none
+    Position getHunterStep(std::uint32_t id, const Position& from);
+    Position getTeleportingMove(std::uint32_t id);
+    // The move of a far ghost, covering kLodFactor near moves
+    Position getFarMove(std::uint32_t id);
+
+    std::uint32_t chunkOf(const Position& p) const {
+        return static_cast<std::uint32_t>((p.y / kLodChunkCells) * lodChunksX + p.x / kLodChunkCells);
+    }
+    bool inLodRange(std::uint32_t chunk, std::uint32_t center) const;
+    void linkFar(std::uint32_t id, std::uint32_t chunk);
+    void unlinkFar(std::uint32_t id);
+    // Puts the far ghosts of chunk back on their exact cadence
+    void promoteChunk(std::uint32_t chunk);
+    // The player moved from chunk `from` (kNone: unknown) to `to`
+    void updatePlayerChunk(std::uint32_t from, std::uint32_t to);
+
+    // Moves the ghosts in dueGhosts and schedules their next moves
+    void moveDueGhosts(const Position& playerPos, const MazeGrid& maze);
+    // Move pass over dueGhosts[begin, end): writes each ghost's wanted
+    // cell, or its current one, to plannedMoves
+    void planMoves(size_t begin, size_t end);
+    // Runs planMoves for task t of the current slot (kGhostsPerTask ghosts)
+    void planMoveTask(int task);
+    bool isValidMove(const Position& from, const Position& newPos, const MazeGrid& maze) const;
+    void ensureLevelTables(const MazeGrid& maze);
+    // Chunk grid of maze, with every ghost near
+    void resetLodTables(const MazeGrid& maze);
+
+    Position findValidGhostPosition(const WalkableIndex& freeCells, int mazeWidth, int mazeHeight);
     GhostType getGhostTypeForDifficulty(int ghostIndex) const;
-    int getGhostCountForDifficulty() const;
+    int getGhostSpeedForDifficulty() const;
 };
 
-#endif
\ No newline at end of file
+#endif
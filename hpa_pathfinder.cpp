@@ -0,0 +1,443 @@
+#include "hpa_pathfinder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+// Runs of facing open cells at least this long get an entrance at each end
+const int kLongRun = 6;
+// Goal trees kept at once
+const size_t kCachedTrees = 4;
+}
+
+const std::int32_t HierarchicalPathfinder::kUnreachable;
+const int HierarchicalPathfinder::kDefaultClusterSize;
+const std::uint32_t HierarchicalPathfinder::kNone;
+
+HierarchicalPathfinder::HierarchicalPathfinder(int size)
+    : clusterSize(std::max(4, size)), width(0), height(0), clustersX(0), clustersY(0),
+      searchStamp(0), lastMissGoal(kNone), useClock(0) {}
+
+void HierarchicalPathfinder::build(const MazeGrid& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    clustersX = (width + clusterSize - 1) / clusterSize;
+    clustersY = (height + clusterSize - 1) / clusterSize;
+    nodes.clear();
+    freeNodes.clear();
+    clusterNodes.assign(static_cast<size_t>(clustersX) * clustersY, std::vector<std::uint32_t>());
+    dirtyFlags.assign(clusterNodes.size(), 0);
+    dirtyClusters.clear();
+    trees.clear();
+    lastMissGoal = kNone;
+    const size_t local = static_cast<size_t>(clusterSize) * clusterSize;
+    localDist.resize(local);
+    localParent.resize(local);
+    localQueue.resize(local);
+
+    for (int cy = 0; cy < clustersY; ++cy) {
+        for (int cx = 0; cx < clustersX; ++cx) {
+            if (cx + 1 < clustersX) scanBorder(maze, cx, cy, true);
+            if (cy + 1 < clustersY) scanBorder(maze, cx, cy, false);
+        }
+    }
+    for (std::uint32_t k = 0; k < clusterNodes.size(); ++k) linkCluster(maze, k);
+}
+
+void HierarchicalPathfinder::markDirty(int x, int y) {
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    std::uint32_t k = clusterOf(x, y);
+    if (dirtyFlags[k]) return;
+    dirtyFlags[k] = 1;
+    dirtyClusters.push_back(k);
+}
+
+std::uint32_t HierarchicalPathfinder::addNode(std::uint32_t cell) {
+    std::uint32_t id;
+    if (!freeNodes.empty()) {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        id = static_cast<std::uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    pos p = cellPos(cell);
+    Node& node = nodes[id];
+    node.cell = cell;
+    node.cluster = clusterOf(p.x, p.y);
+    node.partner = kNone;
+    node.links.clear();
+    clusterNodes[node.cluster].push_back(id);
+    return id;
+}
+
+void HierarchicalPathfinder::removeClusterNodes(std::uint32_t cluster) {
+    // Every node of a cluster sits on one of its borders, so this drops
+    // all entrances around it, including the partners on the other side
+    for (std::uint32_t n : clusterNodes[cluster]) {
+        std::uint32_t p = nodes[n].partner;
+        if (p != kNone) {
+            std::vector<std::uint32_t>& other = clusterNodes[nodes[p].cluster];
+            other.erase(std::find(other.begin(), other.end(), p));
+            nodes[p].partner = kNone;
+            nodes[p].links.clear();
+            freeNodes.push_back(p);
+        }
+        nodes[n].partner = kNone;
+        nodes[n].links.clear();
+        freeNodes.push_back(n);
+    }
+    clusterNodes[cluster].clear();
+}
+
+void HierarchicalPathfinder::scanBorder(const MazeGrid& maze, int cx, int cy, bool vertical) {
+    // Cells on the near side of the border are (a, i), on the far side (b, i)
+    // for a vertical border, (i, a) and (i, b) for a horizontal one
+    const int a = vertical ? (cx + 1) * clusterSize - 1 : (cy + 1) * clusterSize - 1;
+    const int b = a + 1;
+    const int begin = vertical ? cy * clusterSize : cx * clusterSize;
+    const int end = vertical ? std::min(height, begin + clusterSize) : std::min(width, begin + clusterSize);
+    auto cellAt = [&](int side, int i) {
+        return static_cast<std::uint32_t>(vertical ? maze.index(side, i) : maze.index(i, side));
+    };
+    auto facing = [&](int i) {
+        return vertical ? maze(a, i) != '#' && maze(b, i) != '#' : maze(i, a) != '#' && maze(i, b) != '#';
+    };
+    auto addEntrance = [&](int i) {
+        std::uint32_t near = addNode(cellAt(a, i));
+        std::uint32_t far = addNode(cellAt(b, i));
+        nodes[near].partner = far;
+        nodes[far].partner = near;
+    };
+
+    for (int i = begin; i < end;) {
+        if (!facing(i)) {
+            ++i;
+            continue;
+        }
+        int runEnd = i;
+        while (runEnd + 1 < end && facing(runEnd + 1)) ++runEnd;
+        if (runEnd - i + 1 >= kLongRun) {
+            addEntrance(i);
+            addEntrance(runEnd);
+        } else {
+            addEntrance((i + runEnd) / 2);
+        }
+        i = runEnd + 1;
+    }
+}
+
+void HierarchicalPathfinder::linkCluster(const MazeGrid& maze, std::uint32_t cluster) {
+    const std::vector<std::uint32_t>& members = clusterNodes[cluster];
+    for (std::uint32_t n : members) nodes[n].links.clear();
+    for (size_t i = 0; i < members.size(); ++i) {
+        clusterBfs(maze, cluster, nodes[members[i]].cell);
+        for (size_t j = i + 1; j < members.size(); ++j) {
+            std::int32_t d = localDistance(cluster, nodes[members[j]].cell);
+            if (d == kUnreachable) continue;
+            nodes[members[i]].links.push_back(Link{members[j], d});
+            nodes[members[j]].links.push_back(Link{members[i], d});
+        }
+    }
+}
+
+void HierarchicalPathfinder::flushDirty(const MazeGrid& maze) {
+    if (dirtyClusters.empty()) return;
+
+    // Borders to rescan, once each, and the clusters whose node sets change
+    std::vector<std::uint64_t> borders;
+    std::vector<std::uint32_t> relink;
+    for (std::uint32_t k : dirtyClusters) {
+        removeClusterNodes(k);
+        int cx = static_cast<int>(k % clustersX), cy = static_cast<int>(k / clustersX);
+        auto border = [&](int bx, int by, bool vertical) {
+            borders.push_back((static_cast<std::uint64_t>(by * clustersX + bx) << 1) | (vertical ? 1 : 0));
+        };
+        relink.push_back(k);
+        if (cx + 1 < clustersX) { border(cx, cy, true); relink.push_back(k + 1); }
+        if (cx > 0) { border(cx - 1, cy, true); relink.push_back(k - 1); }
+        if (cy + 1 < clustersY) { border(cx, cy, false); relink.push_back(k + clustersX); }
+        if (cy > 0) { border(cx, cy - 1, false); relink.push_back(k - clustersX); }
+        dirtyFlags[k] = 0;
+    }
+    std::sort(borders.begin(), borders.end());
+    borders.erase(std::unique(borders.begin(), borders.end()), borders.end());
+    std::sort(relink.begin(), relink.end());
+    relink.erase(std::unique(relink.begin(), relink.end()), relink.end());
+
+    for (std::uint64_t border : borders) {
+        int k = static_cast<int>(border >> 1);
+        scanBorder(maze, k % clustersX, k / clustersX, (border & 1) != 0);
+    }
+    for (std::uint32_t k : relink) linkCluster(maze, k);
+
+    stats.rebuiltClusters += static_cast<long>(dirtyClusters.size());
+    dirtyClusters.clear();
+    trees.clear();
+    lastMissGoal = kNone;
+}
+
+void HierarchicalPathfinder::clusterBfs(const MazeGrid& maze, std::uint32_t cluster, std::uint32_t cell) {
+    const int x0 = static_cast<int>(cluster % clustersX) * clusterSize;
+    const int y0 = static_cast<int>(cluster / clustersX) * clusterSize;
+    const int x1 = std::min(width, x0 + clusterSize);
+    const int y1 = std::min(height, y0 + clusterSize);
+    std::fill(localDist.begin(), localDist.end(), kUnreachable);
+
+    pos p = cellPos(cell);
+    std::uint32_t start = static_cast<std::uint32_t>((p.y - y0) * clusterSize + (p.x - x0));
+    localDist[start] = 0;
+    localParent[start] = start;
+    localQueue[0] = start;
+    size_t head = 0, tail = 1;
+    const int dx[4] = {-1, 1, 0, 0}, dy[4] = {0, 0, -1, 1};
+    while (head < tail) {
+        std::uint32_t cur = localQueue[head++];
+        int lx = static_cast<int>(cur) % clusterSize, ly = static_cast<int>(cur) / clusterSize;
+        for (int dir = 0; dir < 4; ++dir) {
+            int x = x0 + lx + dx[dir], y = y0 + ly + dy[dir];
+            if (x < x0 || x >= x1 || y < y0 || y >= y1 || maze(x, y) == '#') continue;
+            std::uint32_t n = static_cast<std::uint32_t>((y - y0) * clusterSize + (x - x0));
+            if (localDist[n] != kUnreachable) continue;
+            localDist[n] = localDist[cur] + 1;
+            localParent[n] = cur;
+            localQueue[tail++] = n;
+        }
+    }
+}
+
+std::int32_t HierarchicalPathfinder::localDistance(std::uint32_t cluster, std::uint32_t cell) const {
+    pos p = cellPos(cell);
+    int lx = p.x - static_cast<int>(cluster % clustersX) * clusterSize;
+    int ly = p.y - static_cast<int>(cluster / clustersX) * clusterSize;
+    return localDist[static_cast<size_t>(ly) * clusterSize + lx];
+}
+
+void HierarchicalPathfinder::collectLinks(std::uint32_t cluster, std::vector<Link>& out) const {
+    out.clear();
+    for (std::uint32_t n : clusterNodes[cluster]) {
+        std::int32_t d = localDistance(cluster, nodes[n].cell);
+        if (d != kUnreachable) out.push_back(Link{n, d});
+    }
+}
+
+void HierarchicalPathfinder::beginSearch() {
+    if (g.size() < nodes.size()) {
+        g.resize(nodes.size());
+        parent.resize(nodes.size());
+        stamps.resize(nodes.size(), 0);
+    }
+    if (++searchStamp == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        searchStamp = 1;
+    }
+    heap.clear();
+    stats.lastExpanded = 0;
+}
+
+void HierarchicalPathfinder::push(std::uint32_t node, std::int32_t cost, std::int32_t priority,
+                                  std::uint32_t from) {
+    if (stamps[node] == searchStamp && g[node] <= cost) return;
+    stamps[node] = searchStamp;
+    g[node] = cost;
+    parent[node] = from;
+    heap.push_back((static_cast<std::uint64_t>(priority) << 32) | node);
+    std::push_heap(heap.begin(), heap.end(), std::greater<std::uint64_t>());
+}
+
+HierarchicalPathfinder::GoalTree* HierarchicalPathfinder::findTree(std::uint32_t goal) {
+    for (GoalTree& tree : trees) {
+        if (tree.goal == goal) return &tree;
+    }
+    return nullptr;
+}
+
+HierarchicalPathfinder::GoalTree& HierarchicalPathfinder::buildTree(const MazeGrid& maze, std::uint32_t goal) {
+    // Reuse the least recently used tree once the cache is full
+    if (trees.size() < kCachedTrees) trees.emplace_back();
+    GoalTree* tree = &trees.back();
+    for (GoalTree& t : trees) {
+        if (t.lastUsed < tree->lastUsed) tree = &t;
+    }
+    tree->goal = goal;
+    tree->lastUsed = ++useClock;
+    tree->dist.assign(nodes.size(), kUnreachable);
+    tree->next.assign(nodes.size(), kNone);
+
+    // Dijkstra outward from the goal's cluster; links are symmetric, so
+    // each node's parent is its next step toward the goal
+    pos p = cellPos(goal);
+    std::uint32_t cluster = clusterOf(p.x, p.y);
+    clusterBfs(maze, cluster, goal);
+    collectLinks(cluster, goalLinks);
+    beginSearch();
+    for (const Link& link : goalLinks) push(link.node, link.cost, link.cost, kNone);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<std::uint64_t>());
+        std::uint64_t top = heap.back();
+        heap.pop_back();
+        std::uint32_t node = static_cast<std::uint32_t>(top);
+        std::int32_t cost = static_cast<std::int32_t>(top >> 32);
+        if (cost != g[node]) continue; // stale entry
+        ++stats.lastExpanded;
+        tree->dist[node] = cost;
+        tree->next[node] = parent[node];
+        const Node& n = nodes[node];
+        if (n.partner != kNone) push(n.partner, cost + 1, cost + 1, node);
+        for (const Link& link : n.links) push(link.node, cost + link.cost, cost + link.cost, node);
+    }
+    ++stats.treeBuilds;
+    lastMissGoal = kNone;
+    return *tree;
+}
+
+bool HierarchicalPathfinder::plan(const MazeGrid& maze, int x0, int y0, int x1, int y1, Route& route) {
+    flushDirty(maze);
+    ++stats.queries;
+    stats.lastExpanded = 0;
+    route.waypoints.clear();
+    route.length = kUnreachable;
+    if (maze(x0, y0) == '#' || maze(x1, y1) == '#') return false;
+
+    const std::uint32_t start = static_cast<std::uint32_t>(maze.index(x0, y0));
+    const std::uint32_t goal = static_cast<std::uint32_t>(maze.index(x1, y1));
+    if (start == goal) {
+        route.waypoints.push_back(pos{x0, y0});
+        route.length = 0;
+        return true;
+    }
+    const std::uint32_t startCluster = clusterOf(x0, y0);
+    const std::uint32_t goalCluster = clusterOf(x1, y1);
+    clusterBfs(maze, startCluster, start);
+    collectLinks(startCluster, startLinks);
+    std::int32_t best = startCluster == goalCluster ? localDistance(startCluster, goal) : kUnreachable;
+
+    // A cached tree toward the goal, or a new one for a goal asked for
+    // twice in a row
+    GoalTree* tree = findTree(goal);
+    if (tree) {
+        ++stats.treeHits;
+    } else if (goal == lastMissGoal) {
+        tree = &buildTree(maze, goal);
+    }
+    route.waypoints.push_back(pos{x0, y0});
+    chain.clear();
+
+    if (tree) {
+        tree->lastUsed = ++useClock;
+        std::uint32_t first = kNone;
+        for (const Link& link : startLinks) {
+            std::int32_t rest = tree->dist[link.node];
+            if (rest != kUnreachable && link.cost + rest < best) {
+                best = link.cost + rest;
+                first = link.node;
+            }
+        }
+        if (best == kUnreachable) {
+            route.waypoints.clear();
+            return false;
+        }
+        for (std::uint32_t n = first; n != kNone; n = tree->next[n]) route.waypoints.push_back(cellPos(nodes[n].cell));
+    } else {
+        lastMissGoal = goal;
+        ++stats.searches;
+        clusterBfs(maze, goalCluster, goal);
+        collectLinks(goalCluster, goalLinks);
+
+        // A* over the abstract graph; Manhattan distance never overestimates
+        auto estimate = [&](std::uint32_t node) {
+            pos p = cellPos(nodes[node].cell);
+            return std::abs(p.x - x1) + std::abs(p.y - y1);
+        };
+        std::uint32_t last = kNone;
+        beginSearch();
+        for (const Link& link : startLinks) push(link.node, link.cost, link.cost + estimate(link.node), kNone);
+        while (!heap.empty() && static_cast<std::int32_t>(heap.front() >> 32) < best) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<std::uint64_t>());
+            std::uint64_t top = heap.back();
+            heap.pop_back();
+            std::uint32_t node = static_cast<std::uint32_t>(top);
+            std::int32_t cost = g[node];
+            if (static_cast<std::int32_t>(top >> 32) != cost + estimate(node)) continue; // stale entry
+            ++stats.lastExpanded;
+            const Node& n = nodes[node];
+            if (n.cluster == goalCluster) {
+                for (const Link& link : goalLinks) {
+                    if (link.node == node && cost + link.cost < best) {
+                        best = cost + link.cost;
+                        last = node;
+                    }
+                }
+            }
+            if (n.partner != kNone) push(n.partner, cost + 1, cost + 1 + estimate(n.partner), node);
+            for (const Link& link : n.links) {
+                push(link.node, cost + link.cost, cost + link.cost + estimate(link.node), node);
+            }
+        }
+        if (best == kUnreachable) {
+            route.waypoints.clear();
+            return false;
+        }
+        for (std::uint32_t n = last; n != kNone; n = parent[n]) chain.push_back(n);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) route.waypoints.push_back(cellPos(nodes[*it].cell));
+    }
+
+    route.waypoints.push_back(pos{x1, y1});
+    route.length = best;
+    return true;
+}
+
+void HierarchicalPathfinder::refineSegment(const MazeGrid& maze, const Route& route, size_t segment,
+                                           std::vector<pos>& out) {
+    pos a = route.waypoints[segment];
+    pos b = route.waypoints[segment + 1];
+    if (std::abs(a.x - b.x) + std::abs(a.y - b.y) == 1) {
+        out.push_back(b);
+        return;
+    }
+
+    // Both ends share a cluster: walk the BFS parents back from b
+    std::uint32_t cluster = clusterOf(a.x, a.y);
+    clusterBfs(maze, cluster, static_cast<std::uint32_t>(maze.index(a.x, a.y)));
+    const int x0 = static_cast<int>(cluster % clustersX) * clusterSize;
+    const int y0 = static_cast<int>(cluster / clustersX) * clusterSize;
+    std::uint32_t cur = static_cast<std::uint32_t>((b.y - y0) * clusterSize + (b.x - x0));
+    if (localDist[cur] == kUnreachable) {
+        out.push_back(b);
+        return;
+    }
+    size_t first = out.size();
+    while (localDist[cur] > 0) {
+        out.push_back(pos{x0 + static_cast<int>(cur) % clusterSize, y0 + static_cast<int>(cur) / clusterSize});
+        cur = localParent[cur];
+    }
+    std::reverse(out.begin() + first, out.end());
+}
+
+bool HierarchicalPathfinder::findPath(const MazeGrid& maze, int x0, int y0, int x1, int y1,
+                                      std::vector<pos>& path) {
+    path.clear();
+    Route route;
+    if (!plan(maze, x0, y0, x1, y1, route)) return false;
+    path.push_back(route.waypoints.front());
+    for (size_t i = 0; i + 1 < route.waypoints.size(); ++i) refineSegment(maze, route, i, path);
+    return true;
+}
+
+std::int32_t HierarchicalPathfinder::distance(const MazeGrid& maze, int x0, int y0, int x1, int y1) {
+    Route route;
+    return plan(maze, x0, y0, x1, y1, route) ? route.length : kUnreachable;
+}
+
+size_t HierarchicalPathfinder::memoryBytes() const {
+    size_t bytes = nodes.capacity() * sizeof(Node) + freeNodes.capacity() * sizeof(std::uint32_t) +
+                   clusterNodes.capacity() * sizeof(std::vector<std::uint32_t>) +
+                   (g.capacity() + parent.capacity() + stamps.capacity()) * sizeof(std::uint32_t) +
+                   heap.capacity() * sizeof(std::uint64_t);
+    for (const Node& node : nodes) bytes += node.links.capacity() * sizeof(Link);
+    for (const auto& members : clusterNodes) bytes += members.capacity() * sizeof(std::uint32_t);
+    for (const GoalTree& tree : trees) {
+        bytes += tree.dist.capacity() * sizeof(std::int32_t) + tree.next.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,147 @@
+#ifndef HPA_PATHFINDER_H
+#define HPA_PATHFINDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+#include "pos.h"
+
+// Long-range paths on large mazes (hierarchical pathfinding, HPA*). The grid
+// is cut into square clusters, and every run of open cells facing each other
+// across a cluster border becomes an entrance: a pair of abstract nodes one
+// step apart. The nodes of a cluster are linked by their walking distance
+// inside it. A query joins its start and goal to their clusters with one
+// cluster-sized BFS each and searches the abstract graph, which holds a few
+// percent of the cells.
+//
+// Abstract paths are cached per goal: once a goal has been asked for twice
+// in a row (the exit for the hint, a spawnpoint) a shortest-path tree toward
+// it is built over the abstract graph, and later queries only run the
+// start-side BFS. Routes come back as waypoints; the cells between two of
+// them are filled in when asked for, with a BFS inside one cluster. Cells
+// marked dirty have their cluster's entrances and links rebuilt on the next
+// query, which also drops the cached trees.
+class HierarchicalPathfinder {
+public:
+    static const std::int32_t kUnreachable = INT32_MAX;
+    static const int kDefaultClusterSize = 16;
+
+    // Start to goal; consecutive waypoints share a cluster or are
+    // neighbours across a border
+    struct Route {
+        std::vector<pos> waypoints;
+        std::int32_t length = kUnreachable;
+    };
+
+    struct Stats {
+        long queries = 0;
+        long treeHits = 0;          // answered from a cached goal tree
+        long treeBuilds = 0;
+        long searches = 0;          // abstract A* runs
+        long rebuiltClusters = 0;
+        size_t lastExpanded = 0;    // abstract nodes settled by the last query
+    };
+
+    explicit HierarchicalPathfinder(int clusterSize = kDefaultClusterSize);
+
+    void build(const MazeGrid& maze);
+    bool isBuiltFor(const MazeGrid& maze) const {
+        return width == maze.getWidth() && height == maze.getHeight() && !clusterNodes.empty();
+    }
+    // (x, y) turned from wall to floor or back; its cluster is rebuilt
+    // before the next query
+    void markDirty(int x, int y);
+
+    // Waypoints and length of a path; false if either cell is a wall or the
+    // goal cannot be reached. Paths through one-cell corridors are shortest;
+    // where a wide opening crosses a border the fixed entrances can cost a
+    // few extra steps. Callers keep both cells inside the maze the
+    // pathfinder was built for.
+    bool plan(const MazeGrid& maze, int x0, int y0, int x1, int y1, Route& route);
+    // Appends the cells after waypoint `segment` up to and including the
+    // next one
+    void refineSegment(const MazeGrid& maze, const Route& route, size_t segment, std::vector<pos>& out);
+    // Every cell of the planned path, start and goal included; empty if
+    // there is none
+    bool findPath(const MazeGrid& maze, int x0, int y0, int x1, int y1, std::vector<pos>& path);
+    std::int32_t distance(const MazeGrid& maze, int x0, int y0, int x1, int y1);
+
+    int getClusterSize() const { return clusterSize; }
+    size_t nodeCount() const { return nodes.size() - freeNodes.size(); }
+    const Stats& getStats() const { return stats; }
+    size_t memoryBytes() const;
+
+private:
+    static const std::uint32_t kNone = UINT32_MAX;
+
+    struct Link {
+        std::uint32_t node;
+        std::int32_t cost;
+    };
+    struct Node {
+        std::uint32_t cell;
+        std::uint32_t cluster;
+        std::uint32_t partner;      // the node across the border, one step away
+        std::vector<Link> links;    // nodes of the same cluster
+    };
+    // Shortest-path tree toward one goal cell
+    struct GoalTree {
+        std::uint32_t goal;
+        std::uint64_t lastUsed;
+        std::vector<std::int32_t> dist;     // by node
+        std::vector<std::uint32_t> next;    // by node: next node, kNone once in the goal's cluster
+    };
+
+    int clusterSize;
+    int width, height;
+    int clustersX, clustersY;
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> freeNodes;
+    std::vector<std::vector<std::uint32_t>> clusterNodes;
+    std::vector<std::uint32_t> dirtyClusters;
+    std::vector<std::uint8_t> dirtyFlags;
+
+    // Abstract search scratch; a node's entries are valid when its stamp
+    // matches searchStamp
+    std::vector<std::int32_t> g;
+    std::vector<std::uint32_t> parent;
+    std::vector<std::uint32_t> stamps;
+    std::vector<std::uint64_t> heap;        // (priority << 32) | node
+    std::uint32_t searchStamp;
+    // Cluster BFS scratch, by cell within the cluster
+    std::vector<std::int32_t> localDist;
+    std::vector<std::uint32_t> localParent;
+    std::vector<std::uint32_t> localQueue;
+    std::vector<Link> startLinks, goalLinks;
+    std::vector<std::uint32_t> chain;       // abstract nodes of a found path, goal side first
+
+    std::vector<GoalTree> trees;
+    std::uint32_t lastMissGoal;
+    std::uint64_t useClock;
+    Stats stats;
+
+    std::uint32_t clusterOf(int x, int y) const {
+        return static_cast<std::uint32_t>((y / clusterSize) * clustersX + x / clusterSize);
+    }
+    pos cellPos(std::uint32_t cell) const {
+        return pos{static_cast<int>(cell % width), static_cast<int>(cell / width)};
+    }
+    std::uint32_t addNode(std::uint32_t cell);
+    void removeClusterNodes(std::uint32_t cluster);
+    // Entrances across the border right of / below cluster (cx, cy)
+    void scanBorder(const MazeGrid& maze, int cx, int cy, bool vertical);
+    void linkCluster(const MazeGrid& maze, std::uint32_t cluster);
+    void flushDirty(const MazeGrid& maze);
+    // BFS from cell, staying inside cluster; fills localDist / localParent
+    void clusterBfs(const MazeGrid& maze, std::uint32_t cluster, std::uint32_t cell);
+    std::int32_t localDistance(std::uint32_t cluster, std::uint32_t cell) const;
+    // Costs from cell to the nodes of its cluster, after clusterBfs from it
+    void collectLinks(std::uint32_t cluster, std::vector<Link>& out) const;
+    void beginSearch();
+    void push(std::uint32_t node, std::int32_t cost, std::int32_t priority, std::uint32_t from);
+    GoalTree* findTree(std::uint32_t goal);
+    GoalTree& buildTree(const MazeGrid& maze, std::uint32_t goal);
+};
+
+#endif // HPA_PATHFINDER_H
@@ -0,0 +1,167 @@
+#include "level_pool.h"
+#include "chest_generate.h"
+#include "rng.h"
+#include <algorithm>
+
+Level buildLevel(MazeGenerator& gen, int difficulty, int width, int height, int ghostCount) {
+    gen.setDifficulty(difficulty);
+    if (width > 0 && height > 0) {
+        gen.setDimensions(width, height);
+    }
+    gen.generate();
+
+    Level level;
+    level.difficulty = difficulty;
+    level.seed = gen.getSeed();
+    level.algorithm = gen.getAlgorithm();
+    level.tilesPerSide = gen.getTilesPerSide();
+    level.ghostCount = ghostCount;
+    level.maze = gen.getMaze();
+    level.startX = gen.getStartX();
+    level.startY = gen.getStartY();
+    level.exitX = gen.getExitX();
+    level.exitY = gen.getExitY();
+    level.solution = gen.getSolutionPath();
+
+    // One index of free cells serves chests, ghost spawns and, later,
+    // teleports in the running game
+    level.walkable.build(level.maze);
+    std::mt19937 chestGen = makeRng(level.seed, RNG_CHESTS);
+    level.chests = ChestGenerator::generateChests(
+        level.maze,
+        level.walkable,
+        level.solution,
+        level.startX, level.startY,
+        level.exitX, level.exitY,
+        difficulty,
+        chestGen
+    );
+
+    level.corridors.build(level.maze);
+    level.paths.build(level.maze);
+
+    GhostManager planner(difficulty, level.seed);
+    level.ghostSpawns = planner.planGhostSpawns(level.walkable, level.maze.getWidth(), level.maze.getHeight(),
+                                                ghostCount);
+    return level;
+}
+
+LevelPool::LevelPool(int workerCount, int levelsPerDifficulty, MazeAlgorithmType algo)
+    : stopping(false), target(std::max(1, levelsPerDifficulty)), algorithm(algo),
+      useBitboard(false), generation(0), totalRefillMs(0.0), timedRefills(0) {
+    for (int d = 0; d < kDifficulties; ++d) building[d] = 0;
+    workerCount = std::max(1, workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&LevelPool::workerLoop, this);
+    }
+}
+
+LevelPool::~LevelPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+Level LevelPool::acquire(int difficulty) {
+    MazeAlgorithmType algo;
+    bool bitboard;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (difficulty >= 1 && difficulty <= kDifficulties && !ready[difficulty - 1].empty()) {
+            int d = difficulty - 1;
+            Level level = std::move(ready[d].front());
+            ready[d].pop_front();
+            emptiedAt[d].push_back(std::chrono::steady_clock::now());
+            stats.hits++;
+            wakeWorkers.notify_one();
+            return level;
+        }
+        stats.misses++;
+        algo = algorithm;
+        bitboard = useBitboard;
+    }
+    wakeWorkers.notify_one();
+
+    MazeGenerator gen;
+    gen.setAlgorithm(algo);
+    gen.setUseBitboard(bitboard);
+    return buildLevel(gen, difficulty);
+}
+
+void LevelPool::setAlgorithm(MazeAlgorithmType type) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (type == algorithm) return;
+    algorithm = type;
+    generation++;
+    for (int d = 0; d < kDifficulties; ++d) {
+        ready[d].clear();
+        emptiedAt[d].clear();
+    }
+    wakeWorkers.notify_all();
+}
+
+void LevelPool::setUseBitboard(bool enabled) {
+    // Output is identical either way, so ready levels are kept
+    std::lock_guard<std::mutex> lock(mutex);
+    useBitboard = enabled;
+}
+
+LevelPoolStats LevelPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+int LevelPool::getReadyCount(int difficulty) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (difficulty < 1 || difficulty > kDifficulties) return 0;
+    return (int)ready[difficulty - 1].size();
+}
+
+int LevelPool::neediestDifficulty() const {
+    int best = -1;
+    int bestCount = target;
+    for (int d = 0; d < kDifficulties; ++d) {
+        int count = (int)ready[d].size() + building[d];
+        if (count < bestCount) {
+            best = d;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+void LevelPool::workerLoop() {
+    MazeGenerator gen;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWorkers.wait(lock, [this] { return stopping || neediestDifficulty() >= 0; });
+        if (stopping) return;
+
+        int d = neediestDifficulty();
+        building[d]++;
+        unsigned startedGeneration = generation;
+        gen.setAlgorithm(algorithm);
+        gen.setUseBitboard(useBitboard);
+        lock.unlock();
+
+        Level level = buildLevel(gen, d + 1);
+
+        lock.lock();
+        building[d]--;
+        if (startedGeneration != generation) continue;  // algorithm changed meanwhile
+        ready[d].push_back(std::move(level));
+        stats.refills++;
+        if (!emptiedAt[d].empty()) {
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - emptiedAt[d].front()).count();
+            emptiedAt[d].pop_front();
+            totalRefillMs += ms;
+            timedRefills++;
+            stats.avgRefillMs = totalRefillMs / timedRefills;
+            stats.maxRefillMs = std::max(stats.maxRefillMs, ms);
+        }
+    }
+}
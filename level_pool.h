@@ -0,0 +1,100 @@
+#ifndef LEVEL_POOL_H
+#define LEVEL_POOL_H
+
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_generate.h"
+#include "maze_algorithms.h"
+#include "ghost.h"
+#include "pos.h"
+#include "walkable_index.h"
+#include "corridor_graph.h"
+#include "hpa_pathfinder.h"
+
+// Everything GameManager needs to start a level: the maze (without chests),
+// its start/exit and the carved path between them, chest positions and
+// ghost spawn points, plus what it takes to rebuild it exactly.
+struct Level {
+    int difficulty = 1;
+    std::uint64_t seed = 0;
+    MazeAlgorithmType algorithm = ALGO_BACKTRACKER;
+    int tilesPerSide = 1;
+    int ghostCount = 0;                     // 0 = the difficulty's default
+    MazeGrid maze;
+    int startX = 1, startY = 1;
+    int exitX = 1, exitY = 1;
+    std::vector<std::uint32_t> solution;   // grid indices, start to exit
+    std::vector<pos> chests;
+    std::vector<Position> ghostSpawns;
+    WalkableIndex walkable;                 // free cells, chests already taken out
+    CorridorGraph corridors;                // junctions and corridors of maze
+    HierarchicalPathfinder paths;           // long-range paths on maze (exit hint, spawnpoints)
+};
+
+// Generate a complete level with gen. A non-zero width/height overrides the
+// difficulty's preset maze size, a non-zero ghostCount its ghost count. Uses gen's pending seed if one was set
+// (MazeGenerator::setSeed), so the level is a pure function of the seed,
+// size, difficulty, algorithm and tiling.
+Level buildLevel(MazeGenerator& gen, int difficulty, int width = 0, int height = 0, int ghostCount = 0);
+
+struct LevelPoolStats {
+    long hits = 0;              // acquire() served from a ready level
+    long misses = 0;            // acquire() had to build synchronously
+    long refills = 0;           // levels built by the workers
+    double avgRefillMs = 0.0;   // time from a hit emptying a slot to the slot being refilled
+    double maxRefillMs = 0.0;
+};
+
+// Bounded set of worker threads keeping `levelsPerDifficulty` ready-made
+// preset levels for each difficulty (1-3). acquire() pops one in O(1) and
+// wakes the workers to build its replacement in the background.
+class LevelPool {
+public:
+    LevelPool(int workerCount, int levelsPerDifficulty, MazeAlgorithmType algorithm);
+    ~LevelPool();
+
+    // Pops a ready level, or builds one on the calling thread on a miss
+    Level acquire(int difficulty);
+
+    // Switch carving strategy; levels already built with the old one are dropped
+    void setAlgorithm(MazeAlgorithmType type);
+    // Post-processing representation for levels built from now on
+    void setUseBitboard(bool enabled);
+
+    LevelPoolStats getStats() const;
+    int getReadyCount(int difficulty) const;
+
+private:
+    LevelPool(const LevelPool&);
+    LevelPool& operator=(const LevelPool&);
+
+    static const int kDifficulties = 3;
+
+    void workerLoop();
+    int neediestDifficulty() const;  // requires lock; -1 when every queue is full
+
+    std::vector<std::thread> workers;
+    mutable std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    bool stopping;
+    int target;
+    MazeAlgorithmType algorithm;
+    bool useBitboard;
+    unsigned generation;  // bumped by setAlgorithm to discard in-flight builds
+
+    std::deque<Level> ready[kDifficulties];
+    int building[kDifficulties];
+    std::deque<std::chrono::steady_clock::time_point> emptiedAt[kDifficulties];
+
+    LevelPoolStats stats;
+    double totalRefillMs;
+    long timedRefills;
+};
+
+#endif // LEVEL_POOL_H
@@ -1,9 +1,15 @@
 #include "GameManager.h"
 #include "GameRenderer.h"
 #include "InputHandler.h"
+#include "maze_stream.h"
+#include "rng.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
 
 enum AppState {
     MENU,
@@ -12,12 +18,103 @@ enum AppState {
     GAME_OVER
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     GameManager gameManager;
-    GameRenderer renderer;
     AppState currentState = MENU;
     int selectedDifficulty = 1;
+
+    // Startup options
+    bool haveSeed = false;
+    std::uint64_t seed = 0;
+    bool debugHud = false;
+    bool minimap = false;
+    RenderMode renderMode = RENDER_BLOCKS;
+    int mazeWidth = 0, mazeHeight = 0;     // 0 = the difficulty's preset size
+    std::string streamFile;                 // --stream-maze: write this maze and exit
+    int streamWidth = 0, streamHeight = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--algorithm" && i + 1 < argc) {
+            MazeAlgorithmType type;
+            if (!mazeAlgorithmFromName(argv[++i], type)) {
+                std::cerr << "Unknown maze algorithm: " << argv[i]
+                          << " (expected backtracker, kruskal, wilson, eller or growing-tree)" << std::endl;
+                return 1;
+            }
+            gameManager.setMazeAlgorithm(type);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            // Reproducible runs: every level is built from this seed
+            if (!parseSeed(argv[++i], seed)) {
+                std::cerr << "Invalid seed: " << argv[i] << " (expected a non-negative integer)" << std::endl;
+                return 1;
+            }
+            haveSeed = true;
+            gameManager.setSeed(seed);
+        } else if (arg == "--ghosts" && i + 1 < argc) {
+            int count = std::atoi(argv[++i]);
+            if (count <= 0) {
+                std::cerr << "Invalid ghost count: " << argv[i] << " (expected a positive integer)" << std::endl;
+                return 1;
+            }
+            gameManager.setGhostCount(count);
+        } else if (arg == "--bitboard") {
+            gameManager.setUseBitboard(true);
+        } else if (arg == "--debug-hud") {
+            debugHud = true;
+        } else if (arg == "--minimap") {
+            minimap = true;
+        } else if (arg == "--render" && i + 1 < argc) {
+            // Half blocks and plain ASCII fit more maze in fewer bytes
+            if (!renderModeFromName(argv[++i], renderMode)) {
+                std::cerr << "Unknown render mode: " << argv[i]
+                          << " (expected blocks, half or ascii)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--size" && i + 2 < argc) {
+            // Custom maze size for every difficulty; the view scrolls when
+            // it does not fit the terminal
+            mazeWidth = std::atoi(argv[++i]);
+            mazeHeight = std::atoi(argv[++i]);
+            // Smaller mazes leave no room for ghosts away from the start
+            if (mazeWidth < 9 || mazeHeight < 9) {
+                std::cerr << "Invalid maze size: " << argv[i - 1] << " " << argv[i]
+                          << " (expected two integers of at least 9)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stream-maze" && i + 3 < argc) {
+            streamFile = argv[++i];
+            streamWidth = std::atoi(argv[++i]);
+            streamHeight = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--algorithm NAME] [--seed N] [--ghosts N] [--bitboard] [--size WIDTH HEIGHT] [--debug-hud] [--minimap] [--render MODE] [--stream-maze FILE WIDTH HEIGHT]" << std::endl;
+            return 1;
+        }
+    }
     
+    if (!streamFile.empty()) {
+        // Write a maze of any size straight to disk and exit, with the
+        // seed wherever it came on the command line
+        std::mt19937 gen = makeRng(haveSeed ? seed : randomSeed(), RNG_MAZE);
+        std::string err;
+        if (!streamMazeToFile(streamFile, streamWidth, streamHeight, 1, gen, err)) {
+            std::cerr << "Stream error: " << err << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Keep a couple of levels per difficulty ready so starting and
+    // restarting never waits for maze generation
+    unsigned cores = std::thread::hardware_concurrency();
+    int levelWorkers = cores > 2 ? std::min(3, (int)cores - 1) : 1;
+    gameManager.enableLevelPool(levelWorkers, 2);
+
+    GameRenderer renderer;
+    renderer.setDebugHud(debugHud);
+    renderer.setMinimap(minimap);
+    renderer.setRenderMode(renderMode);
+
     // Initialize input handler
     InputHandler::initialize();
     
@@ -25,9 +122,7 @@ int main() {
     renderer.initialize();
     
     // Timing variables
-    auto lastGhostUpdate = std::chrono::steady_clock::now();
     auto lastRenderTime = std::chrono::steady_clock::now();
-    const auto ghostUpdateInterval = std::chrono::milliseconds(500);  // Update ghosts every 500ms
     const auto renderInterval = std::chrono::milliseconds(150);      // Render every 150ms to prevent flickering
     
     // Track game over state to prevent flickering
@@ -50,25 +145,21 @@ int main() {
                 case KEY_1:
                     selectedDifficulty = 1;
                     currentState = PLAYING;
-                    gameManager.initializeGame(1);
-                    lastGhostUpdate = currentTime;
+                    gameManager.initializeGame(1, mazeWidth, mazeHeight);
                     break;
                 case KEY_2:
                     selectedDifficulty = 2;
                     currentState = PLAYING;
-                    gameManager.initializeGame(2);
-                    lastGhostUpdate = currentTime;
+                    gameManager.initializeGame(2, mazeWidth, mazeHeight);
                     break;
                 case KEY_3:
                     selectedDifficulty = 3;
                     currentState = PLAYING;
-                    gameManager.initializeGame(3);
-                    lastGhostUpdate = currentTime;
+                    gameManager.initializeGame(3, mazeWidth, mazeHeight);
                     break;
                 case KEY_4:
                     if (gameManager.loadGame("savegame.txt")) {
                         currentState = PLAYING;
-                        lastGhostUpdate = currentTime;
                     } else {
                         std::cout << "Failed to load game!" << std::endl;
                     }
@@ -109,14 +200,21 @@ int main() {
                     if (gameManager.saveGame("savegame.txt")) {
                         // Show save message temporarily (could be improved with overlay)
                     } else {
-                        // Show error message
+                        // The error went to the terminal; repaint over it
+                        renderer.invalidate();
                     }
                     break;
                 case KEY_M:
                     gameManager.markSpawnpoint();
                     break;
                 case KEY_R:
-                    gameManager.goToSpawnpoint();
+                    if (!gameManager.goToSpawnpoint()) {
+                        // A warning may have gone to the terminal; repaint over it
+                        renderer.invalidate();
+                    }
+                    break;
+                case KEY_H:
+                    gameManager.toggleHint();
                     break;
                 case KEY_ESCAPE:
                     currentState = MENU;
@@ -127,11 +225,8 @@ int main() {
             
             // Update game logic (ghosts move automatically even if player doesn't move)
             if (!gameManager.isGamePaused()) {
-                // Update ghosts periodically
-                if (currentTime - lastGhostUpdate >= ghostUpdateInterval) {
-                    gameManager.update();
-                    lastGhostUpdate = currentTime;
-                }
+                // Ghosts move on game time, whenever their next move is due
+                gameManager.update();
                 
                 // Check game over/win conditions
                 if (gameManager.isGameOver()) {
@@ -147,6 +242,8 @@ int main() {
             if (!gameManager.isGameOver() && currentTime - lastRenderTime >= renderInterval) {
                 renderer.renderGame(gameManager);
                 lastRenderTime = currentTime;
+                // Keep every ghost in view on exact simulation
+                gameManager.setViewSize(renderer.getViewWidth(), renderer.getViewHeight());
             }
         }
         else if (currentState == PAUSED) {
@@ -175,7 +272,6 @@ int main() {
                 case KEY_R:
                     currentState = PLAYING;
                     gameManager.resetGame();
-                    lastGhostUpdate = std::chrono::steady_clock::now();
                     gameOverRendered = false;  // Reset flag when leaving game over state
                     break;
                 case KEY_ESCAPE:
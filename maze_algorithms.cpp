@@ -0,0 +1,473 @@
+#include "maze_algorithms.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+// All 24 orderings of the four directions, so one RNG draw picks a whole
+// shuffled direction order without building a vector per step.
+const unsigned char kDirPermutations[24][4] = {
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {0, 3, 2, 1},
+    {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0}, {1, 3, 0, 2}, {1, 3, 2, 0},
+    {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 1, 0, 3}, {2, 1, 3, 0}, {2, 3, 0, 1}, {2, 3, 1, 0},
+    {3, 0, 1, 2}, {3, 0, 2, 1}, {3, 1, 0, 2}, {3, 1, 2, 0}, {3, 2, 0, 1}, {3, 2, 1, 0},
+};
+
+// Unvisited carving cells two steps from cur, one bit per direction
+// (0 = left, 1 = right, 2 = up, 3 = down). An open carving cell is visited.
+unsigned unvisitedMask(const MazeGrid& maze, std::uint32_t cur) {
+    const char* cells = maze.data();
+    const std::ptrdiff_t stride = maze.getStride();
+    int cx = static_cast<int>(cur % stride);
+    int cy = static_cast<int>(cur / stride);
+    unsigned mask = 0;
+    if (cx > 2 && cells[cur - 2] == '#') mask |= 1u;
+    if (cx + 2 < maze.getWidth() - 1 && cells[cur + 2] == '#') mask |= 2u;
+    if (cy > 2 && cells[cur - 2 * stride] == '#') mask |= 4u;
+    if (cy + 2 < maze.getHeight() - 1 && cells[cur + 2 * stride] == '#') mask |= 8u;
+    return mask;
+}
+
+// The first direction of a uniformly random ordering that is in mask is a
+// uniform pick among the directions in mask
+int pickDirection(unsigned mask, std::mt19937& gen) {
+    std::uniform_int_distribution<int> pickOrder(0, 23);
+    const unsigned char* order = kDirPermutations[pickOrder(gen)];
+    for (int k = 0; k < 4; ++k) {
+        if (mask & (1u << order[k])) return order[k];
+    }
+    return order[0];
+}
+
+// Opens the wall towards dir and the carving cell beyond it, returns that cell
+std::uint32_t carveStep(MazeGrid& maze, std::uint32_t cur, int dir) {
+    const std::ptrdiff_t stride = maze.getStride();
+    const std::ptrdiff_t offset[4] = {-1, 1, -stride, stride};
+    char* cells = maze.data();
+    cells[cur + offset[dir]] = ' ';
+    std::uint32_t next = static_cast<std::uint32_t>(cur + 2 * offset[dir]);
+    cells[next] = ' ';
+    return next;
+}
+
+// Iterative recursive-backtracker. The explicit stack holds one 32-bit cell
+// index per frame, so memory is bounded by 4 bytes per carving cell
+// independent of the native stack size.
+class BacktrackerAlgorithm : public MazeAlgorithm {
+public:
+    MazeAlgorithmType getType() const override { return ALGO_BACKTRACKER; }
+
+protected:
+    void carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) override {
+        std::vector<std::uint32_t> stack;
+        stack.push_back(static_cast<std::uint32_t>(maze.index(startX, startY)));
+        maze.data()[stack.back()] = ' ';
+        size_t peak = 1;
+        // The stack is the tree path from the start to its top cell
+        if (hasTarget && stack.back() == target) pathFromCells(maze, stack);
+
+        while (!stack.empty()) {
+            unsigned mask = unvisitedMask(maze, stack.back());
+            if (mask == 0) {
+                stack.pop_back();
+                continue;
+            }
+            stack.push_back(carveStep(maze, stack.back(), pickDirection(mask, gen)));
+            if (stack.size() > peak) peak = stack.size();
+            if (hasTarget && stack.back() == target) pathFromCells(maze, stack);
+        }
+        stats.peakAuxBytes = peak * sizeof(std::uint32_t);
+    }
+};
+
+// Randomised Kruskal: shuffle every wall between neighbouring carving cells
+// and open it when it joins two different union-find components. The result
+// is a spanning tree, hence connected by construction.
+class KruskalAlgorithm : public MazeAlgorithm {
+public:
+    MazeAlgorithmType getType() const override { return ALGO_KRUSKAL; }
+
+protected:
+    void carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) override {
+        const int cw = (maze.getWidth() - 1) / 2;
+        const int ch = (maze.getHeight() - 1) / 2;
+        const std::uint32_t count = static_cast<std::uint32_t>(cw) * ch;
+        if (count == 0) return;
+
+        // Edge id = cell * 2 + (0: wall to the right, 1: wall below)
+        std::vector<std::uint32_t> edges;
+        edges.reserve(static_cast<size_t>(count) * 2);
+        for (int j = 0; j < ch; ++j) {
+            for (int i = 0; i < cw; ++i) {
+                std::uint32_t c = static_cast<std::uint32_t>(j) * cw + i;
+                maze(2 * i + 1, 2 * j + 1) = ' ';
+                if (i + 1 < cw) edges.push_back(c * 2);
+                if (j + 1 < ch) edges.push_back(c * 2 + 1);
+            }
+        }
+        std::shuffle(edges.begin(), edges.end(), gen);
+
+        parent.resize(count);
+        std::iota(parent.begin(), parent.end(), 0u);
+        rank.assign(count, 0);
+
+        std::uint32_t joins = 0;
+        for (std::uint32_t e : edges) {
+            std::uint32_t a = e >> 1;
+            std::uint32_t b = (e & 1u) ? a + cw : a + 1;
+            std::uint32_t ra = find(a), rb = find(b);
+            if (ra == rb) continue;
+            if (rank[ra] < rank[rb]) std::swap(ra, rb);
+            parent[rb] = ra;
+            if (rank[ra] == rank[rb]) ++rank[ra];
+
+            int i = static_cast<int>(a % cw), j = static_cast<int>(a / cw);
+            if (e & 1u) maze(2 * i + 1, 2 * j + 2) = ' ';
+            else maze(2 * i + 2, 2 * j + 1) = ' ';
+            if (++joins == count - 1) break;
+        }
+        stats.peakAuxBytes = edges.capacity() * sizeof(std::uint32_t) +
+                             parent.capacity() * sizeof(std::uint32_t) + rank.capacity();
+        std::vector<std::uint32_t>().swap(parent);
+        std::vector<unsigned char>().swap(rank);
+        if (hasTarget) pathByTreeWalk(maze, startX, startY);
+    }
+
+private:
+    std::vector<std::uint32_t> parent;
+    std::vector<unsigned char> rank;
+
+    // Path halving keeps the trees flat without recursion
+    std::uint32_t find(std::uint32_t c) {
+        while (parent[c] != c) {
+            parent[c] = parent[parent[c]];
+            c = parent[c];
+        }
+        return c;
+    }
+};
+
+// Wilson's algorithm: loop-erased random walks from every cell outside the
+// tree until they hit it. Produces a uniformly random spanning tree.
+class WilsonAlgorithm : public MazeAlgorithm {
+public:
+    MazeAlgorithmType getType() const override { return ALGO_WILSON; }
+
+protected:
+    void carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) override {
+        const int cw = (maze.getWidth() - 1) / 2;
+        const int ch = (maze.getHeight() - 1) / 2;
+        const std::uint32_t count = static_cast<std::uint32_t>(cw) * ch;
+        if (count == 0) return;
+
+        std::vector<char> inTree(count, 0);
+        std::vector<unsigned char> walkDir(count, 0);
+        std::uniform_int_distribution<int> pickDir(0, 3);
+        const int di[4] = {-1, 1, 0, 0};
+        const int dj[4] = {0, 0, -1, 1};
+
+        int si = (startX - 1) / 2, sj = (startY - 1) / 2;
+        inTree[static_cast<std::uint32_t>(sj) * cw + si] = 1;
+        maze(startX, startY) = ' ';
+
+        for (std::uint32_t first = 0; first < count; ++first) {
+            if (inTree[first]) continue;
+
+            // Random walk until the tree is hit; overwriting walkDir on
+            // revisits erases the loops implicitly
+            std::uint32_t cur = first;
+            while (!inTree[cur]) {
+                int i = static_cast<int>(cur % cw), j = static_cast<int>(cur / cw);
+                int d, ni, nj;
+                do {
+                    d = pickDir(gen);
+                    ni = i + di[d];
+                    nj = j + dj[d];
+                } while (ni < 0 || ni >= cw || nj < 0 || nj >= ch);
+                walkDir[cur] = static_cast<unsigned char>(d);
+                cur = static_cast<std::uint32_t>(nj) * cw + ni;
+            }
+
+            // Retrace the loop-erased path, adding it to the tree
+            cur = first;
+            while (!inTree[cur]) {
+                int i = static_cast<int>(cur % cw), j = static_cast<int>(cur / cw);
+                int d = walkDir[cur];
+                inTree[cur] = 1;
+                maze(2 * i + 1, 2 * j + 1) = ' ';
+                maze(2 * i + 1 + di[d], 2 * j + 1 + dj[d]) = ' ';
+                cur = static_cast<std::uint32_t>(j + dj[d]) * cw + (i + di[d]);
+            }
+        }
+        stats.peakAuxBytes = inTree.capacity() + walkDir.capacity();
+        // Once a cell joins the tree its walkDir points towards the start
+        if (hasTarget) pathFromParents(maze, walkDir, startX, startY);
+    }
+};
+
+// Eller's algorithm written straight into the grid one row at a time
+class EllerAlgorithm : public MazeAlgorithm {
+public:
+    MazeAlgorithmType getType() const override { return ALGO_ELLER; }
+
+protected:
+    void carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) override {
+        const int cw = (maze.getWidth() - 1) / 2;
+        const int ch = (maze.getHeight() - 1) / 2;
+        if (cw == 0 || ch == 0) return;
+
+        EllerRowState rows(cw);
+        std::vector<char> right, down;
+        for (int j = 0; j < ch; ++j) {
+            rows.nextRow(j == ch - 1, gen, right, down);
+            char* row = maze.row(2 * j + 1);
+            char* below = maze.row(2 * j + 2);
+            for (int i = 0; i < cw; ++i) {
+                row[2 * i + 1] = ' ';
+                if (right[i]) row[2 * i + 2] = ' ';
+                if (down[i]) below[2 * i + 1] = ' ';
+            }
+        }
+        stats.peakAuxBytes = rows.memoryBytes() + right.capacity() + down.capacity();
+        if (hasTarget) pathByTreeWalk(maze, startX, startY);
+    }
+};
+
+// Growing tree: keep a list of active cells, extend from the newest one half
+// of the time and from a random one otherwise. Mixes backtracker corridors
+// with Prim-style branching.
+class GrowingTreeAlgorithm : public MazeAlgorithm {
+public:
+    MazeAlgorithmType getType() const override { return ALGO_GROWING_TREE; }
+
+protected:
+    void carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) override {
+        const int cw = (maze.getWidth() - 1) / 2;
+        const std::ptrdiff_t stride = maze.getStride();
+        std::vector<std::uint32_t> active;
+        active.push_back(static_cast<std::uint32_t>(maze.index(startX, startY)));
+        maze.data()[active.back()] = ' ';
+        size_t peak = 1;
+
+        // Direction from each carving cell back to the one it was carved from
+        std::vector<unsigned char> parentDir;
+        if (hasTarget) parentDir.assign(static_cast<size_t>(cw) * ((maze.getHeight() - 1) / 2), 0);
+
+        while (!active.empty()) {
+            size_t pick = active.size() - 1;
+            if (gen() & 1u) {
+                pick = std::uniform_int_distribution<size_t>(0, active.size() - 1)(gen);
+            }
+            unsigned mask = unvisitedMask(maze, active[pick]);
+            if (mask == 0) {
+                active[pick] = active.back();
+                active.pop_back();
+                continue;
+            }
+            int dir = pickDirection(mask, gen);
+            std::uint32_t next = carveStep(maze, active[pick], dir);
+            active.push_back(next);
+            if (active.size() > peak) peak = active.size();
+            if (hasTarget) {
+                int x = static_cast<int>(next % stride), y = static_cast<int>(next / stride);
+                parentDir[static_cast<size_t>(y / 2) * cw + x / 2] = static_cast<unsigned char>(dir ^ 1);
+            }
+        }
+        stats.peakAuxBytes = peak * sizeof(std::uint32_t) + parentDir.capacity();
+        if (hasTarget) pathFromParents(maze, parentDir, startX, startY);
+    }
+};
+
+} // namespace
+
+const char* mazeAlgorithmName(MazeAlgorithmType type) {
+    switch (type) {
+        case ALGO_BACKTRACKER: return "backtracker";
+        case ALGO_KRUSKAL: return "kruskal";
+        case ALGO_WILSON: return "wilson";
+        case ALGO_ELLER: return "eller";
+        case ALGO_GROWING_TREE: return "growing-tree";
+        default: return "unknown";
+    }
+}
+
+bool mazeAlgorithmFromName(const std::string& name, MazeAlgorithmType& type) {
+    const MazeAlgorithmType all[] = {ALGO_BACKTRACKER, ALGO_KRUSKAL, ALGO_WILSON,
+                                     ALGO_ELLER, ALGO_GROWING_TREE};
+    for (MazeAlgorithmType t : all) {
+        if (name == mazeAlgorithmName(t)) {
+            type = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MazeAlgorithm::run(MazeGrid& maze, int startX, int startY, std::mt19937& gen) {
+    hasTarget = false;
+    path.clear();
+    stats = MazeCarveStats();
+    stats.cells = maze.cellCount();
+    auto begin = std::chrono::steady_clock::now();
+    carve(maze, startX, startY, gen);
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void MazeAlgorithm::run(MazeGrid& maze, int startX, int startY, int exitX, int exitY,
+                        std::mt19937& gen) {
+    path.clear();
+    // Only carving cells (odd coordinates) are part of the tree
+    hasTarget = maze.inBounds(exitX, exitY) && (exitX & 1) && (exitY & 1);
+    target = hasTarget ? static_cast<std::uint32_t>(maze.index(exitX, exitY)) : 0;
+
+    stats = MazeCarveStats();
+    stats.cells = maze.cellCount();
+    auto begin = std::chrono::steady_clock::now();
+    carve(maze, startX, startY, gen);
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    hasTarget = false;
+}
+
+void MazeAlgorithm::pathFromParents(const MazeGrid& maze, const std::vector<unsigned char>& parentDir,
+                                    int startX, int startY) {
+    const int cw = (maze.getWidth() - 1) / 2;
+    const std::ptrdiff_t stride = maze.getStride();
+    const std::ptrdiff_t offset[4] = {-1, 1, -stride, stride};
+    const std::uint32_t start = static_cast<std::uint32_t>(maze.index(startX, startY));
+
+    path.clear();
+    std::uint32_t cur = target;
+    path.push_back(cur);
+    while (cur != start && path.size() <= maze.cellCount()) {
+        int x = static_cast<int>(cur % stride), y = static_cast<int>(cur / stride);
+        int dir = parentDir[static_cast<size_t>(y / 2) * cw + x / 2];
+        path.push_back(static_cast<std::uint32_t>(cur + offset[dir]));
+        cur = static_cast<std::uint32_t>(cur + 2 * offset[dir]);
+        path.push_back(cur);
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+void MazeAlgorithm::pathFromCells(const MazeGrid&, const std::vector<std::uint32_t>& cells) {
+    path.clear();
+    path.reserve(cells.size() * 2);
+    for (size_t k = 0; k < cells.size(); ++k) {
+        if (k > 0) path.push_back((cells[k - 1] + cells[k]) / 2);  // wall between them
+        path.push_back(cells[k]);
+    }
+}
+
+void MazeAlgorithm::pathByTreeWalk(const MazeGrid& maze, int startX, int startY) {
+    const int cw = (maze.getWidth() - 1) / 2;
+    const int ch = (maze.getHeight() - 1) / 2;
+    const std::ptrdiff_t stride = maze.getStride();
+    const std::ptrdiff_t offset[4] = {-1, 1, -stride, stride};
+    const char* cells = maze.data();
+    const unsigned char kUnseen = 4;
+
+    // Depth-first over carving cells only; in a tree the cell we came from
+    // is the only neighbour already seen, so parentDir doubles as visited
+    std::vector<unsigned char> parentDir(static_cast<size_t>(cw) * ch, kUnseen);
+    std::vector<std::uint32_t> stack;
+    std::uint32_t start = static_cast<std::uint32_t>(maze.index(startX, startY));
+    stack.push_back(start);
+    parentDir[static_cast<size_t>(startY / 2) * cw + startX / 2] = 0;
+    while (!stack.empty()) {
+        std::uint32_t cur = stack.back(); stack.pop_back();
+        if (cur == target) break;
+        int x = static_cast<int>(cur % stride), y = static_cast<int>(cur / stride);
+        const bool inside[4] = {x > 1, x + 2 < maze.getWidth() - 1, y > 1, y + 2 < maze.getHeight() - 1};
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!inside[dir] || cells[cur + offset[dir]] == '#') continue;
+            std::uint32_t next = static_cast<std::uint32_t>(cur + 2 * offset[dir]);
+            int nx = static_cast<int>(next % stride), ny = static_cast<int>(next / stride);
+            unsigned char& seen = parentDir[static_cast<size_t>(ny / 2) * cw + nx / 2];
+            if (seen != kUnseen) continue;
+            seen = static_cast<unsigned char>(dir ^ 1);
+            stack.push_back(next);
+        }
+    }
+    if (parentDir[static_cast<size_t>((target / stride) / 2) * cw + (target % stride) / 2] == kUnseen) return;
+    pathFromParents(maze, parentDir, startX, startY);
+    stats.peakAuxBytes = std::max(stats.peakAuxBytes,
+                                  parentDir.capacity() + stack.capacity() * sizeof(std::uint32_t));
+}
+
+std::unique_ptr<MazeAlgorithm> createMazeAlgorithm(MazeAlgorithmType type) {
+    switch (type) {
+        case ALGO_KRUSKAL: return std::unique_ptr<MazeAlgorithm>(new KruskalAlgorithm());
+        case ALGO_WILSON: return std::unique_ptr<MazeAlgorithm>(new WilsonAlgorithm());
+        case ALGO_ELLER: return std::unique_ptr<MazeAlgorithm>(new EllerAlgorithm());
+        case ALGO_GROWING_TREE: return std::unique_ptr<MazeAlgorithm>(new GrowingTreeAlgorithm());
+        case ALGO_BACKTRACKER:
+        default: return std::unique_ptr<MazeAlgorithm>(new BacktrackerAlgorithm());
+    }
+}
+
+// EllerRowState implementation
+EllerRowState::EllerRowState(int cellCount)
+    : cells(cellCount), setOf(cellCount), parent(2 * cellCount),
+      remaining(2 * cellCount, 0), hasDown(2 * cellCount, 0),
+      relabel(2 * cellCount, -1), nextLabel(cellCount) {
+    std::iota(setOf.begin(), setOf.end(), 0);
+}
+
+int EllerRowState::find(int label) {
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];
+        label = parent[label];
+    }
+    return label;
+}
+
+void EllerRowState::nextRow(bool lastRow, std::mt19937& gen,
+                            std::vector<char>& right, std::vector<char>& down) {
+    right.assign(cells, 0);
+    down.assign(cells, 0);
+    for (int c = 0; c < cells; ++c) parent[setOf[c]] = setOf[c];
+
+    // Join neighbours from different sets at random; the last row joins all
+    for (int c = 0; c + 1 < cells; ++c) {
+        int a = find(setOf[c]), b = find(setOf[c + 1]);
+        if (a != b && (lastRow || (gen() & 1u))) {
+            right[c] = 1;
+            parent[b] = a;
+        }
+    }
+    for (int c = 0; c < cells; ++c) setOf[c] = find(setOf[c]);
+    if (lastRow) return;
+
+    // Every set needs at least one opening into the next row
+    for (int c = 0; c < cells; ++c) {
+        ++remaining[setOf[c]];
+        hasDown[setOf[c]] = 0;
+    }
+    for (int c = 0; c < cells; ++c) {
+        int s = setOf[c];
+        --remaining[s];
+        if ((gen() & 1u) || (remaining[s] == 0 && !hasDown[s])) {
+            down[c] = 1;
+            hasDown[s] = 1;
+        }
+    }
+
+    // Cells without an opening above start fresh sets, then labels are
+    // compacted back into [0, cells) so the label space stays O(width)
+    nextLabel = cells;
+    for (int c = 0; c < cells; ++c) {
+        if (!down[c]) setOf[c] = nextLabel++;
+    }
+    int compact = 0;
+    for (int c = 0; c < cells; ++c) {
+        int& mapped = relabel[setOf[c]];
+        if (mapped < 0) mapped = compact++;
+        setOf[c] = mapped;
+    }
+    for (int l = 0; l < 2 * cells; ++l) relabel[l] = -1;
+}
+
+size_t EllerRowState::memoryBytes() const {
+    return (setOf.capacity() + parent.capacity() + remaining.capacity() + relabel.capacity()) * sizeof(int) +
+           hasDown.capacity();
+}
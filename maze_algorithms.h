@@ -0,0 +1,98 @@
+#ifndef MAZE_ALGORITHMS_H
+#define MAZE_ALGORITHMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "maze_grid.h"
+
+// Carving strategies selectable at runtime by MazeGenerator.
+// Every strategy carves a perfect maze (a spanning tree) on the odd (x, y)
+// "carving cells" of an all-wall grid whose width and height are odd.
+enum MazeAlgorithmType {
+    ALGO_BACKTRACKER,   // Recursive backtracker (iterative DFS), long corridors
+    ALGO_KRUSKAL,       // Randomised Kruskal over a path-compressed union-find
+    ALGO_WILSON,        // Loop-erased random walks, uniform spanning tree
+    ALGO_ELLER,         // Row-by-row sets, O(width) working state
+    ALGO_GROWING_TREE   // Mix of newest/random active-cell selection
+};
+
+const char* mazeAlgorithmName(MazeAlgorithmType type);
+// Parses "backtracker", "kruskal", "wilson", "eller" or "growing-tree"
+bool mazeAlgorithmFromName(const std::string& name, MazeAlgorithmType& type);
+
+struct MazeCarveStats {
+    size_t cells = 0;           // grid cells covered by the carve
+    double seconds = 0.0;
+    size_t peakAuxBytes = 0;    // working memory beyond the grid itself
+    double cellsPerSecond() const { return seconds > 0.0 ? cells / seconds : 0.0; }
+};
+
+class MazeAlgorithm {
+public:
+    MazeAlgorithm() : hasTarget(false), target(0) {}
+    virtual ~MazeAlgorithm() {}
+
+    virtual MazeAlgorithmType getType() const = 0;
+    const char* getName() const { return mazeAlgorithmName(getType()); }
+
+    // Carves maze (all '#' on entry) and records timing in getStats()
+    void run(MazeGrid& maze, int startX, int startY, std::mt19937& gen);
+    // Same, and also publishes the path from the start to the exit carving
+    // cell through the carved tree in getPath()
+    void run(MazeGrid& maze, int startX, int startY, int exitX, int exitY, std::mt19937& gen);
+    const MazeCarveStats& getStats() const { return stats; }
+
+    // Grid indices of every cell from start to exit inclusive, carving cells
+    // and the walls opened between them. Empty when no exit was given.
+    const std::vector<std::uint32_t>& getPath() const { return path; }
+
+protected:
+    // Must fill path when hasTarget is set
+    virtual void carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) = 0;
+
+    // Path from parentDir, one entry per carving cell (j * cw + i) giving the
+    // direction (0 = left, 1 = right, 2 = up, 3 = down) towards the start
+    void pathFromParents(const MazeGrid& maze, const std::vector<unsigned char>& parentDir,
+                         int startX, int startY);
+    // Path from a chain of adjacent carving cells (grid indices), start first
+    void pathFromCells(const MazeGrid& maze, const std::vector<std::uint32_t>& cells);
+    // For strategies that do not orient their tree while carving: walk the
+    // finished tree from the start until the exit is found
+    void pathByTreeWalk(const MazeGrid& maze, int startX, int startY);
+
+    MazeCarveStats stats;
+    bool hasTarget;
+    std::uint32_t target;   // grid index of the exit carving cell
+    std::vector<std::uint32_t> path;
+};
+
+std::unique_ptr<MazeAlgorithm> createMazeAlgorithm(MazeAlgorithmType type);
+
+// Eller's row state over `cells` carving cells per row. Each call to nextRow
+// decides the openings of one row using only O(cells) memory:
+// right[i] opens the wall between cell i and i + 1, down[i] opens the wall
+// below cell i (never set on the last row).
+class EllerRowState {
+public:
+    explicit EllerRowState(int cells);
+    void nextRow(bool lastRow, std::mt19937& gen,
+                 std::vector<char>& right, std::vector<char>& down);
+    size_t memoryBytes() const;
+
+private:
+    int cells;
+    std::vector<int> setOf;       // set label per column in the current row
+    std::vector<int> parent;      // union-find over labels while joining a row
+    std::vector<int> remaining;   // members per set not yet given a down decision
+    std::vector<char> hasDown;    // set already has a downward opening
+    std::vector<int> relabel;     // label compaction between rows
+    int nextLabel;
+
+    int find(int label);
+};
+
+#endif // MAZE_ALGORITHMS_H
@@ -0,0 +1,38 @@
+#include "maze_bitboard.h"
+
+void MazeBitboard::load(const MazeGrid& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    wordsPerRow = (width + 63) / 64;
+    bits.assign(static_cast<size_t>(wordsPerRow) * height, 0);
+
+    for (int y = 0; y < height; ++y) {
+        const char* cells = maze.row(y);
+        std::uint64_t* out = row(y);
+        for (int word = 0; word < wordsPerRow; ++word) {
+            int base = word * 64;
+            int end = base + 64 < width ? base + 64 : width;
+            std::uint64_t v = 0;
+            for (int x = base; x < end; ++x) {
+                v |= std::uint64_t(cells[x] != '#') << (x - base);
+            }
+            out[word] = v;
+        }
+    }
+}
+
+void MazeBitboard::store(MazeGrid& maze) const {
+    for (int y = 0; y < height; ++y) {
+        char* cells = maze.row(y);
+        const std::uint64_t* in = row(y);
+        for (int word = 0; word < wordsPerRow; ++word) {
+            std::uint64_t v = in[word];
+            int base = word * 64;
+            int end = base + 64 < width ? base + 64 : width;
+            for (int x = base; x < end; ++x, v >>= 1) {
+                char c = cells[x];
+                cells[x] = !(v & 1u) ? '#' : (c == '#' ? ' ' : c);
+            }
+        }
+    }
+}
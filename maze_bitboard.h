@@ -0,0 +1,60 @@
+#ifndef MAZE_BITBOARD_H
+#define MAZE_BITBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+
+// Bit-packed open/wall mask of a MazeGrid: one bit per cell, 64 cells per
+// word, bit (x % 64) of word x / 64 of a row is cell x. A set bit is an open
+// cell. Bits past the grid width are always clear, so they read as wall.
+// The post-processing passes in maze_postprocess have overloads over this
+// type that work a whole word of cells at a time.
+class MazeBitboard {
+public:
+    MazeBitboard() : width(0), height(0), wordsPerRow(0) {}
+    explicit MazeBitboard(const MazeGrid& maze) : width(0), height(0), wordsPerRow(0) {
+        load(maze);
+    }
+
+    // Every cell that is not '#' becomes an open bit
+    void load(const MazeGrid& maze);
+    // Writes the mask back: open bits whose cell is '#' become ' ' and clear
+    // bits become '#'. Other open cells keep their character.
+    void store(MazeGrid& maze) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getWordsPerRow() const { return wordsPerRow; }
+    size_t memoryBytes() const { return bits.size() * sizeof(std::uint64_t); }
+
+    // Unchecked access, caller guarantees the cell is inside the grid
+    bool isOpen(int x, int y) const {
+        return (row(y)[x >> 6] >> (x & 63)) & 1u;
+    }
+    void setOpen(int x, int y, bool open) {
+        std::uint64_t bit = std::uint64_t(1) << (x & 63);
+        if (open) row(y)[x >> 6] |= bit;
+        else row(y)[x >> 6] &= ~bit;
+    }
+
+    // Cells x0, x0 + 1, x0 + 2 of row y as bits 0..2. x0 + 2 must be < width.
+    unsigned window3(int x0, int y) const {
+        const std::uint64_t* r = row(y);
+        int word = x0 >> 6, shift = x0 & 63;
+        std::uint64_t v = r[word] >> shift;
+        if (shift > 61) v |= r[word + 1] << (64 - shift);
+        return static_cast<unsigned>(v & 7u);
+    }
+
+    const std::uint64_t* row(int y) const { return bits.data() + static_cast<size_t>(y) * wordsPerRow; }
+    std::uint64_t* row(int y) { return bits.data() + static_cast<size_t>(y) * wordsPerRow; }
+
+private:
+    int width, height;
+    int wordsPerRow;
+    std::vector<std::uint64_t> bits;
+};
+
+#endif // MAZE_BITBOARD_H
@@ -1,19 +1,58 @@
 #ifndef MAZE_H
 #define MAZE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <random>
+#include "maze_grid.h"
+#include "maze_algorithms.h"
+
+class ThreadPool;
 
 class MazeGenerator {
 public:
     MazeGenerator();
+    ~MazeGenerator();
 
     // 1/2/3
     void setDifficulty(int level);
+    // Custom size, keeps the current difficulty for passage density.
+    // Each side is capped at 65535 so cell indices fit in 32 bits.
+    void setDimensions(int w, int h);
+
+    // Carving strategy used by generate(), backtracker by default
+    void setAlgorithm(MazeAlgorithmType type);
+    MazeAlgorithmType getAlgorithm() const;
+    // Timing and memory of the most recent carve
+    const MazeCarveStats& getCarveStats() const;
+
+    // Run the post-processing passes on a 64-cells-per-word bitboard
+    // instead of the char grid; the output is identical either way
+    void setUseBitboard(bool enabled);
+    bool getUseBitboard() const;
+
+    // Carve in tiles x tiles regions on `threads` threads (see
+    // TiledMazeAlgorithm); tiles <= 1 carves the whole grid on one thread
+    void setTiling(int tiles, int threads);
+    int getTilesPerSide() const;
+
+    // Level seed for the next generate(). Without one, each generate()
+    // draws a fresh random seed. All randomness of the maze comes from the
+    // RNG_MAZE stream of the seed, so the same seed, size, difficulty,
+    // algorithm and tiling always give the same maze.
+    void setSeed(std::uint64_t seed);
+    // Seed of the most recently generated maze
+    std::uint64_t getSeed() const;
 
     void generate();
 
-    const std::vector<std::vector<char>>& getMaze() const;
+    const MazeGrid& getMaze() const;
+    // Grid indices from start to exit along the carved tree, start first.
+    // Always open in the generated maze, though extra passages may have
+    // made shorter routes. Empty for mazes given through setMaze.
+    const std::vector<std::uint32_t>& getSolutionPath() const;
     int getWidth() const;
     int getHeight() const;
     int getStartX() const;
@@ -23,26 +62,25 @@ public:
     int getDifficulty() const;
     
     // For loading saved games
-    void setMaze(const std::vector<std::vector<char>>& loadedMaze, int w, int h, 
+    void setMaze(MazeGrid loadedMaze, int w, int h, 
                  int sx, int sy, int ex, int ey, int diff);
 
 private:
     int width, height;
     int difficulty;
+    bool useBitboard;
+    int tilesPerSide;
     int startX, startY;
     int exitX, exitY;
-    std::vector<std::vector<char>> maze;
+    MazeGrid maze;
+    std::vector<std::uint32_t> solution;
+    std::unique_ptr<MazeAlgorithm> algorithm;
+    std::unique_ptr<ThreadPool> tilePool;
+    std::unique_ptr<MazeAlgorithm> tiledAlgorithm;   // wraps algorithm's type when tiling
 
-    std::random_device rd;
+    std::uint64_t seed;
+    bool seedPending;
     std::mt19937 gen;
-
-    const int dx[4] = {-1, 1, 0, 0};
-    const int dy[4] = {0, 0, -1, 1};
-
-    void dfs(int x, int y, std::vector<std::vector<bool>>& visited);
-    void ensureReachable();
-    void addExtraPassages();
-    void removeOpenAreas();
 };
 
 #endif 
@@ -0,0 +1,74 @@
+#ifndef MAZE_GRID_H
+#define MAZE_GRID_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Row-major maze storage shared by every subsystem.
+// All cells live in one contiguous buffer: cell (x, y) is data()[y * stride + x].
+class MazeGrid {
+public:
+    // Largest side a game maze may have, so cell indices fit in 32 bits
+    static constexpr int kMaxSide = 65535;
+
+    MazeGrid() : width(0), height(0), stride(0) {}
+    MazeGrid(int w, int h, char fill = '#') : width(0), height(0), stride(0) {
+        assign(w, h, fill);
+    }
+
+    // Resize to w x h and set every cell to fill
+    void assign(int w, int h, char fill = '#') {
+        width = w < 0 ? 0 : w;
+        height = h < 0 ? 0 : h;
+        stride = width;
+        cells.assign(static_cast<size_t>(stride) * height, fill);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }
+    size_t cellCount() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+
+    bool inBounds(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+    size_t index(int x, int y) const {
+        return static_cast<size_t>(y) * stride + x;
+    }
+
+    // Unchecked access, caller guarantees inBounds(x, y)
+    char operator()(int x, int y) const { return cells[index(x, y)]; }
+    char& operator()(int x, int y) { return cells[index(x, y)]; }
+
+    // Bounds-checked access
+    char at(int x, int y) const {
+        if (!inBounds(x, y)) throw std::out_of_range("MazeGrid::at");
+        return cells[index(x, y)];
+    }
+    char& at(int x, int y) {
+        if (!inBounds(x, y)) throw std::out_of_range("MazeGrid::at");
+        return cells[index(x, y)];
+    }
+
+    // Anything outside the grid counts as wall
+    bool isWall(int x, int y) const {
+        return !inBounds(x, y) || cells[index(x, y)] == '#';
+    }
+
+    const char* row(int y) const { return cells.data() + index(0, y); }
+    char* row(int y) { return cells.data() + index(0, y); }
+    std::string rowString(int y) const { return std::string(row(y), width); }
+
+    const char* data() const { return cells.data(); }
+    char* data() { return cells.data(); }
+
+private:
+    int width, height;
+    int stride;
+    std::vector<char> cells;
+};
+
+#endif // MAZE_GRID_H
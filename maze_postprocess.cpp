@@ -0,0 +1,330 @@
+#include "maze_postprocess.h"
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const int dx[4] = {-1, 1, 0, 0};
+const int dy[4] = {0, 0, -1, 1};
+
+bool isOpenBlock(const MazeGrid& maze, int x, int y) {
+    return maze(x, y) == ' ' && maze(x + 1, y) == ' ' &&
+           maze(x, y + 1) == ' ' && maze(x + 1, y + 1) == ' ';
+}
+
+// Kogge-Stone occluded fills: spread the set bits of gen through the set
+// bits of open towards higher (left shift) or lower (right shift) bit indices.
+std::uint64_t fillUp(std::uint64_t gen, std::uint64_t open) {
+    gen &= open;
+    gen |= open & (gen << 1);  open &= open << 1;
+    gen |= open & (gen << 2);  open &= open << 2;
+    gen |= open & (gen << 4);  open &= open << 4;
+    gen |= open & (gen << 8);  open &= open << 8;
+    gen |= open & (gen << 16); open &= open << 16;
+    gen |= open & (gen << 32);
+    return gen;
+}
+
+std::uint64_t fillDown(std::uint64_t gen, std::uint64_t open) {
+    gen &= open;
+    gen |= open & (gen >> 1);  open &= open >> 1;
+    gen |= open & (gen >> 2);  open &= open >> 2;
+    gen |= open & (gen >> 4);  open &= open >> 4;
+    gen |= open & (gen >> 8);  open &= open >> 8;
+    gen |= open & (gen >> 16); open &= open >> 16;
+    gen |= open & (gen >> 32);
+    return gen;
+}
+
+// Grow seen along the open runs of row words [lo, hi], carrying across word
+// boundaries for as long as a run continues past the range. One pass each
+// way is enough: the upward pass reaches the top of every run holding a
+// seed, the downward pass then reaches the bottom. Widens [lo, hi] to cover
+// every word that changed.
+void fillRow(std::uint64_t* seen, const std::uint64_t* open, int words, int& lo, int& hi) {
+    std::uint64_t carry = 0;
+    int i = lo;
+    for (; i < words && (i <= hi || carry); ++i) {
+        seen[i] = fillUp(seen[i] | (carry & open[i]), open[i]);
+        carry = seen[i] >> 63;
+    }
+    hi = i - 1;
+    carry = 0;
+    for (i = hi; i >= 0 && (i >= lo || carry); --i) {
+        seen[i] = fillDown(seen[i] | (carry & open[i]), open[i]);
+        carry = (seen[i] & 1u) << 63;
+    }
+    lo = i + 1;
+}
+
+// 3x3 window around a wall cell, bits 0-2 the row above, 3-5 its own row,
+// 6-8 the row below. The four orthogonal neighbours are bits 1, 3, 5 and 7.
+const unsigned kNeighbourMask = 0xAA;
+const unsigned kCentreBit = 1u << 4;
+
+// For every window: would opening the centre complete an open 2x2 block?
+struct Forms2x2Table {
+    bool value[512];
+    Forms2x2Table() {
+        static const unsigned quads[4] = {
+            (1u << 0) | (1u << 1) | (1u << 3) | (1u << 4),
+            (1u << 1) | (1u << 2) | (1u << 4) | (1u << 5),
+            (1u << 3) | (1u << 4) | (1u << 6) | (1u << 7),
+            (1u << 4) | (1u << 5) | (1u << 7) | (1u << 8)
+        };
+        for (unsigned w = 0; w < 512; ++w) {
+            unsigned opened = w | kCentreBit;
+            value[w] = false;
+            for (unsigned q : quads) {
+                if ((opened & q) == q) value[w] = true;
+            }
+        }
+    }
+};
+
+const Forms2x2Table kForms2x2;
+
+} // namespace
+
+void ensureReachable(MazeGrid& maze, int startX, int startY, int exitX, int exitY) {
+    int h = maze.getHeight(), w = maze.getWidth();
+    std::vector<bool> vis(maze.cellCount(), false);
+    std::queue<std::pair<int, int>> q;
+    q.push(std::make_pair(startX, startY));
+    vis[maze.index(startX, startY)] = true;
+    while (!q.empty()) {
+        std::pair<int, int> p = q.front(); q.pop();
+        int x = p.first, y = p.second;
+        for (int i = 0; i < 4; ++i) {
+            int nx = x + dx[i], ny = y + dy[i];
+            if (nx >= 0 && nx < w && ny >= 0 && ny < h && !vis[maze.index(nx, ny)] && maze(nx, ny) != '#') {
+                vis[maze.index(nx, ny)] = true;
+                q.push(std::make_pair(nx, ny));
+            }
+        }
+    }
+    if (vis[maze.index(exitX, exitY)]) return;
+    int x = exitX, y = exitY;
+    maze(x, y) = ' ';
+    while (x != startX || y != startY) {
+        if (x > startX) --x;
+        else if (x < startX) ++x;
+        else if (y > startY) --y;
+        else if (y < startY) ++y;
+        maze(x, y) = ' ';
+    }
+}
+
+int extraPassageAttempts(int difficulty, int width, int height) {
+    switch (difficulty) {
+        case 1: return width * height / 80;
+        case 2: return width * height / 50;
+        case 3: return width * height / 30;
+        default: return width * height / 50;
+    }
+}
+
+void addExtraPassages(MazeGrid& maze, int difficulty, std::mt19937& gen) {
+    const int width = maze.getWidth(), height = maze.getHeight();
+    int attempts = extraPassageAttempts(difficulty, width, height);
+    if (attempts <= 0) return;
+
+    std::uniform_int_distribution<> xr(1, width - 2);
+    std::uniform_int_distribution<> yr(1, height - 2);
+
+    for (int i = 0; i < attempts; ++i) {
+        int x = xr(gen), y = yr(gen);
+        if (maze(x, y) != '#') continue;
+
+        int pathNeighbors = 0;
+        for (int k = 0; k < 4; ++k) {
+            int nx = x + dx[k], ny = y + dy[k];
+            if (nx >= 0 && nx < width && ny >= 0 && ny < height && maze(nx, ny) == ' ')
+                ++pathNeighbors;
+        }
+        if (pathNeighbors < 2) continue;
+        bool forms2x2 = false;
+        for (int yy = y - 1; yy <= y; ++yy) {
+            for (int xx = x - 1; xx <= x; ++xx) {
+                if (xx >= 0 && xx + 1 < width && yy >= 0 && yy + 1 < height) {
+                    int empty = 0;
+                    for (int ry = 0; ry < 2; ++ry) for (int rx = 0; rx < 2; ++rx) {
+                        int cx = xx + rx, cy = yy + ry;
+                        if ((cx == x && cy == y) || maze(cx, cy) == ' ') ++empty;
+                    }
+                    if (empty == 4) { forms2x2 = true; break; }
+                }
+            }
+            if (forms2x2) break;
+        }
+        if (forms2x2) continue;
+        maze(x, y) = ' ';
+    }
+}
+
+void removeOpenAreas(MazeGrid& maze, int startX, int startY, int exitX, int exitY,
+                     std::mt19937& gen) {
+    std::vector<std::uint32_t> keep = {static_cast<std::uint32_t>(maze.index(startX, startY)),
+                                       static_cast<std::uint32_t>(maze.index(exitX, exitY))};
+    removeOpenAreas(maze, keep, gen);
+}
+
+void removeOpenAreas(MazeGrid& maze, const std::vector<std::uint32_t>& keep, std::mt19937& gen) {
+    const int width = maze.getWidth();
+    const int height = maze.getHeight();
+    std::vector<std::uint64_t> kept((maze.cellCount() + 63) / 64, 0);
+    for (std::uint32_t k : keep) kept[k >> 6] |= std::uint64_t(1) << (k & 63);
+
+    // Seed the worklist with every open block (top-left corner index)
+    std::vector<std::uint32_t> work;
+    for (int y = 0; y < height - 1; ++y) {
+        for (int x = 0; x < width - 1; ++x) {
+            if (isOpenBlock(maze, x, y)) work.push_back(static_cast<std::uint32_t>(maze.index(x, y)));
+        }
+    }
+
+    const int stride = maze.getStride();
+    for (std::uint32_t block : work) {
+        int x = static_cast<int>(block % stride);
+        int y = static_cast<int>(block / stride);
+        // An earlier wall may already have closed this block
+        if (!isOpenBlock(maze, x, y)) continue;
+
+        std::pair<int, int> cells[4] = {{x, y}, {x + 1, y}, {x, y + 1}, {x + 1, y + 1}};
+        std::shuffle(cells, cells + 4, gen);
+        for (const auto& c : cells) {
+            size_t k = maze.index(c.first, c.second);
+            if ((kept[k >> 6] >> (k & 63)) & 1u) continue;
+            maze(c.first, c.second) = '#';
+            break;
+        }
+    }
+}
+
+void ensureReachable(MazeBitboard& maze, int startX, int startY, int exitX, int exitY) {
+    const int height = maze.getHeight();
+    const int words = maze.getWordsPerRow();
+    std::vector<std::uint64_t> seen(static_cast<size_t>(words) * height, 0);
+    // Queued rows and the word range of each that gained cells since it was last filled
+    std::vector<int> rows;
+    std::vector<int> dirtyLo(height, words), dirtyHi(height, -1);
+
+    if (maze.isOpen(startX, startY)) {
+        seen[static_cast<size_t>(startY) * words + (startX >> 6)] |= std::uint64_t(1) << (startX & 63);
+        rows.push_back(startY);
+        dirtyLo[startY] = dirtyHi[startY] = startX >> 6;
+    }
+
+    // Row worklist: flood a row sideways, then push whatever of it leaks
+    // into the rows above and below. Rows are requeued until nothing new is
+    // seen; only the words that changed are revisited.
+    while (!rows.empty()) {
+        int y = rows.back(); rows.pop_back();
+        int lo = dirtyLo[y], hi = dirtyHi[y];
+        dirtyLo[y] = words;
+        dirtyHi[y] = -1;
+        std::uint64_t* cur = seen.data() + static_cast<size_t>(y) * words;
+        fillRow(cur, maze.row(y), words, lo, hi);
+
+        for (int ny = y - 1; ny <= y + 1; ny += 2) {
+            if (ny < 0 || ny >= height) continue;
+            std::uint64_t* next = seen.data() + static_cast<size_t>(ny) * words;
+            const std::uint64_t* open = maze.row(ny);
+            for (int i = lo; i <= hi; ++i) {
+                std::uint64_t add = cur[i] & open[i] & ~next[i];
+                if (!add) continue;
+                next[i] |= add;
+                if (dirtyHi[ny] < 0) rows.push_back(ny);
+                dirtyLo[ny] = std::min(dirtyLo[ny], i);
+                dirtyHi[ny] = std::max(dirtyHi[ny], i);
+            }
+        }
+    }
+
+    if ((seen[static_cast<size_t>(exitY) * words + (exitX >> 6)] >> (exitX & 63)) & 1u) return;
+    int x = exitX, y = exitY;
+    maze.setOpen(x, y, true);
+    while (x != startX || y != startY) {
+        if (x > startX) --x;
+        else if (x < startX) ++x;
+        else if (y > startY) --y;
+        else if (y < startY) ++y;
+        maze.setOpen(x, y, true);
+    }
+}
+
+void addExtraPassages(MazeBitboard& maze, int difficulty, std::mt19937& gen) {
+    const int width = maze.getWidth(), height = maze.getHeight();
+    int attempts = extraPassageAttempts(difficulty, width, height);
+    if (attempts <= 0) return;
+
+    std::uniform_int_distribution<> xr(1, width - 2);
+    std::uniform_int_distribution<> yr(1, height - 2);
+
+    for (int i = 0; i < attempts; ++i) {
+        int x = xr(gen), y = yr(gen);
+        if (maze.isOpen(x, y)) continue;
+
+        unsigned window = maze.window3(x - 1, y - 1) |
+                          (maze.window3(x - 1, y) << 3) |
+                          (maze.window3(x - 1, y + 1) << 6);
+        if (__builtin_popcount(window & kNeighbourMask) < 2) continue;
+        if (kForms2x2.value[window]) continue;
+        maze.setOpen(x, y, true);
+    }
+}
+
+void removeOpenAreas(MazeBitboard& maze, int startX, int startY, int exitX, int exitY,
+                     std::mt19937& gen) {
+    const std::uint32_t width = static_cast<std::uint32_t>(maze.getWidth());
+    std::vector<std::uint32_t> keep = {startY * width + startX, exitY * width + exitX};
+    removeOpenAreas(maze, keep, gen);
+}
+
+void removeOpenAreas(MazeBitboard& maze, const std::vector<std::uint32_t>& keep, std::mt19937& gen) {
+    const int width = maze.getWidth();
+    const int height = maze.getHeight();
+    const int words = maze.getWordsPerRow();
+    std::vector<std::uint64_t> blocks(words);
+    // Kept cells in the bitboard's own row/word layout
+    std::vector<std::uint64_t> kept(static_cast<size_t>(words) * height, 0);
+    for (std::uint32_t k : keep) {
+        int x = static_cast<int>(k % width), y = static_cast<int>(k / width);
+        kept[static_cast<size_t>(y) * words + (x >> 6)] |= std::uint64_t(1) << (x & 63);
+    }
+
+    // Same raster order as the MazeGrid worklist. Block bits for a row are
+    // taken when the row is reached rather than up front: walls only close
+    // blocks, so this yields the same candidates, and each is still re-checked.
+    for (int y = 0; y + 1 < height; ++y) {
+        const std::uint64_t* top = maze.row(y);
+        const std::uint64_t* bottom = maze.row(y + 1);
+        for (int i = 0; i < words; ++i) {
+            std::uint64_t both = top[i] & bottom[i];
+            std::uint64_t nextBoth = i + 1 < words ? (top[i + 1] & bottom[i + 1]) : 0;
+            // Bit x: cells x and x + 1 of both rows open
+            blocks[i] = both & ((both >> 1) | (nextBoth << 63));
+        }
+
+        for (int i = 0; i < words; ++i) {
+            std::uint64_t pending = blocks[i];
+            while (pending) {
+                int x = i * 64 + __builtin_ctzll(pending);
+                pending &= pending - 1;
+                if (!(maze.isOpen(x, y) && maze.isOpen(x + 1, y) &&
+                      maze.isOpen(x, y + 1) && maze.isOpen(x + 1, y + 1))) continue;
+
+                std::pair<int, int> cells[4] = {{x, y}, {x + 1, y}, {x, y + 1}, {x + 1, y + 1}};
+                std::shuffle(cells, cells + 4, gen);
+                for (const auto& c : cells) {
+                    if ((kept[static_cast<size_t>(c.second) * words + (c.first >> 6)] >> (c.first & 63)) & 1u) continue;
+                    maze.setOpen(c.first, c.second, false);
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef MAZE_POSTPROCESS_H
+#define MAZE_POSTPROCESS_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "maze_grid.h"
+#include "maze_bitboard.h"
+
+// Post-processing passes run by MazeGenerator after carving. They are free
+// functions over MazeGrid so benchmarks can drive them on arbitrary grids.
+
+// Make sure the exit is reachable from the start: BFS from the start and, if
+// the exit was not reached, dig a straight L-shaped corridor between them.
+void ensureReachable(MazeGrid& maze, int startX, int startY, int exitX, int exitY);
+
+// Number of random wall-knockout attempts addExtraPassages makes
+int extraPassageAttempts(int difficulty, int width, int height);
+
+// Knock out random walls that join at least two corridors without forming
+// an open 2x2 block, adding loops to the perfect maze.
+void addExtraPassages(MazeGrid& maze, int difficulty, std::mt19937& gen);
+
+// Wall off one cell of every open 2x2 block, never the start or exit cell.
+// Worklist engine: open blocks are collected in one scan and processed in
+// raster order. Placing a wall can only close the (up to four) blocks that
+// contain it, never open one, so each queued block is re-checked when it is
+// popped and no further rescans are needed. The result is identical to
+// rescanning the grid until nothing changes, given the same RNG state.
+void removeOpenAreas(MazeGrid& maze, int startX, int startY, int exitX, int exitY,
+                     std::mt19937& gen);
+// Same, never walling any cell in keep (grid indices). With keep holding the
+// carved start-to-exit path the exit stays reachable: every open 2x2 block
+// holds an even-even corner cell, which a carved path never passes through.
+void removeOpenAreas(MazeGrid& maze, const std::vector<std::uint32_t>& keep, std::mt19937& gen);
+
+// Bitboard kernels for the same passes. Given the same RNG state they make
+// exactly the same changes as the MazeGrid versions above, but test and
+// update 64 cells per word: reachability floods whole corridor runs with an
+// occluded fill, extra passages look their 3x3 window up in a table, and the
+// open-block scan ANDs adjacent rows and shifted copies of them.
+void ensureReachable(MazeBitboard& maze, int startX, int startY, int exitX, int exitY);
+void addExtraPassages(MazeBitboard& maze, int difficulty, std::mt19937& gen);
+void removeOpenAreas(MazeBitboard& maze, int startX, int startY, int exitX, int exitY,
+                     std::mt19937& gen);
+void removeOpenAreas(MazeBitboard& maze, const std::vector<std::uint32_t>& keep, std::mt19937& gen);
+
+#endif // MAZE_POSTPROCESS_H
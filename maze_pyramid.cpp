@@ -0,0 +1,73 @@
+#include "maze_pyramid.h"
+#include <algorithm>
+
+MazePyramid::MazePyramid() {
+}
+
+void MazePyramid::build(const MazeGrid& maze) {
+    levels.clear();
+    const int width = maze.getWidth();
+    const int height = maze.getHeight();
+    if (width <= 0 || height <= 0) return;
+
+    // Level 0 straight from the maze: 2x2 blocks, clipped at odd edges
+    Level first;
+    first.width = (width + 1) / 2;
+    first.height = (height + 1) / 2;
+    first.open.resize(static_cast<size_t>(first.width) * first.height);
+    for (int by = 0; by < first.height; by++) {
+        const int y0 = 2 * by, y1 = y0 + 1 < height ? y0 + 1 : y0;
+        for (int bx = 0; bx < first.width; bx++) {
+            const int x0 = 2 * bx, x1 = x0 + 1 < width ? x0 + 1 : x0;
+            const int cells = (y1 - y0 + 1) * (x1 - x0 + 1);
+            int open = 0;
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) open += maze(x, y) != '#';
+            }
+            first.open[static_cast<size_t>(by) * first.width + bx] =
+                static_cast<std::uint8_t>(open * 255 / cells);
+        }
+    }
+    levels.push_back(std::move(first));
+
+    // Each further level averages 2x2 entries of the previous one, weighted
+    // by how many maze cells each covers so clipped edge blocks count less
+    int scale = 2;
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const Level& prev = levels.back();
+        Level next;
+        next.width = (prev.width + 1) / 2;
+        next.height = (prev.height + 1) / 2;
+        next.open.resize(static_cast<size_t>(next.width) * next.height);
+        for (int by = 0; by < next.height; by++) {
+            for (int bx = 0; bx < next.width; bx++) {
+                long sum = 0, weight = 0;
+                for (int y = 2 * by; y < 2 * by + 2 && y < prev.height; y++) {
+                    const int cellsY = std::min(scale, height - y * scale);
+                    for (int x = 2 * bx; x < 2 * bx + 2 && x < prev.width; x++) {
+                        const int cellsX = std::min(scale, width - x * scale);
+                        const long cells = static_cast<long>(cellsX) * cellsY;
+                        sum += prev.open[static_cast<size_t>(y) * prev.width + x] * cells;
+                        weight += cells;
+                    }
+                }
+                next.open[static_cast<size_t>(by) * next.width + bx] = static_cast<std::uint8_t>(sum / weight);
+            }
+        }
+        levels.push_back(std::move(next));
+        scale *= 2;
+    }
+}
+
+int MazePyramid::levelToFit(int maxWidth, int maxHeight) const {
+    for (int level = 0; level < levelCount(); level++) {
+        if (levels[level].width <= maxWidth && levels[level].height <= maxHeight) return level;
+    }
+    return levelCount() - 1;
+}
+
+size_t MazePyramid::memoryBytes() const {
+    size_t bytes = levels.capacity() * sizeof(Level);
+    for (const Level& level : levels) bytes += level.open.capacity();
+    return bytes;
+}
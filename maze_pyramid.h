@@ -0,0 +1,44 @@
+#ifndef MAZE_PYRAMID_H
+#define MAZE_PYRAMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+
+// Mip pyramid of a maze for downsampled views such as the minimap. Level 0
+// is half the maze's resolution, and every further level halves the one
+// before it (odd sizes round up). Each entry is how open its block of maze
+// cells is, from 0 (all wall) to 255 (all floor), averaged over the cells
+// the block actually covers. Built once per maze, in O(cells).
+class MazePyramid {
+public:
+    MazePyramid();
+
+    void build(const MazeGrid& maze);
+    bool empty() const { return levels.empty(); }
+
+    int levelCount() const { return static_cast<int>(levels.size()); }
+    int levelWidth(int level) const { return levels[level].width; }
+    int levelHeight(int level) const { return levels[level].height; }
+    // Maze cells per entry side at a level: 2, 4, 8, ...
+    int levelScale(int level) const { return 2 << level; }
+    std::uint8_t openness(int level, int x, int y) const {
+        const Level& l = levels[level];
+        return l.open[static_cast<size_t>(y) * l.width + x];
+    }
+    // The finest level that fits in maxWidth x maxHeight entries; the
+    // coarsest level if none does
+    int levelToFit(int maxWidth, int maxHeight) const;
+
+    size_t memoryBytes() const;
+
+private:
+    struct Level {
+        int width, height;
+        std::vector<std::uint8_t> open;
+    };
+    std::vector<Level> levels;
+};
+
+#endif // MAZE_PYRAMID_H
@@ -0,0 +1,69 @@
+#include "maze_stream.h"
+#include "maze_algorithms.h"
+#include <cstdio>   // std::rename, std::remove
+#include <fstream>
+#include <vector>
+
+bool streamMazeToFile(const std::string& filename, int width, int height, int difficulty,
+                      std::mt19937& gen, std::string& err) {
+    if (width % 2 == 0) --width;
+    if (height % 2 == 0) --height;
+    if (width < 3 || height < 3) {
+        err = "Streamed maze must be at least 3x3";
+        return false;
+    }
+
+    std::string tmp = filename + ".tmp";
+    std::ofstream ofs(tmp, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!ofs.is_open()) {
+        err = "Failed to open temporary maze file for writing: " + tmp;
+        return false;
+    }
+
+    // Same header as saveGameToFile
+    ofs << difficulty << "\n";
+    ofs << width << " " << height << "\n";
+    ofs << 1 << " " << 1 << "\n";
+    ofs << (width - 2) << " " << (height - 2) << "\n";
+    ofs << 0 << "\n";
+
+    const int cw = (width - 1) / 2;
+    const int ch = (height - 1) / 2;
+    std::string cellLine(width + 1, '#');
+    std::string wallLine(width + 1, '#');
+    cellLine[width] = '\n';
+    wallLine[width] = '\n';
+
+    // Top border
+    ofs.write(wallLine.data(), wallLine.size());
+
+    EllerRowState rows(cw);
+    std::vector<char> right, down;
+    for (int j = 0; j < ch && ofs.good(); ++j) {
+        rows.nextRow(j == ch - 1, gen, right, down);
+        for (int i = 0; i < cw; ++i) {
+            cellLine[2 * i + 1] = ' ';
+            cellLine[2 * i + 2] = right[i] ? ' ' : '#';
+            wallLine[2 * i + 1] = down[i] ? ' ' : '#';
+        }
+        cellLine[width - 1] = '#';
+        // On the last row nothing opens downwards, so wallLine is the bottom border
+        ofs.write(cellLine.data(), cellLine.size());
+        ofs.write(wallLine.data(), wallLine.size());
+    }
+
+    if (!ofs.good()) {
+        ofs.close();
+        std::remove(tmp.c_str());
+        err = "Error while writing to temporary maze file";
+        return false;
+    }
+    ofs.close();
+
+    if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        err = "Failed to rename temporary maze file to final filename";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef MAZE_STREAM_H
+#define MAZE_STREAM_H
+
+#include <random>
+#include <string>
+
+// Out-of-core maze generation. Eller's algorithm keeps only O(width) state
+// and each row is written to disk as soon as it is decided, so the maze is
+// never materialised in memory and its size is bounded only by disk space.
+//
+// The output uses the save-file format read by loadGameFromFile and
+// MappedMazeFile: the player starts at (1, 1), the exit is at
+// (width - 2, height - 2) and moves is 0. Even sizes are rounded down to odd.
+// The result is a perfect maze, no extra passages are drilled.
+// Writes atomically through filename + ".tmp". On error, returns false and fills err.
+bool streamMazeToFile(const std::string& filename, int width, int height, int difficulty,
+                      std::mt19937& gen, std::string& err);
+
+#endif // MAZE_STREAM_H
@@ -0,0 +1,102 @@
+#include "maze_tiled.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+// First carving cell of tile t when n cells are split into k tiles
+int tileBegin(int t, int n, int k) {
+    return static_cast<int>(static_cast<long long>(t) * n / k);
+}
+
+int findTile(std::vector<int>& parent, int t) {
+    while (parent[t] != t) {
+        parent[t] = parent[parent[t]];
+        t = parent[t];
+    }
+    return t;
+}
+
+} // namespace
+
+TiledMazeAlgorithm::TiledMazeAlgorithm(MazeAlgorithmType innerType, int tiles, ThreadPool& threadPool)
+    : inner(innerType), tilesPerSide(std::max(1, tiles)), pool(threadPool) {}
+
+void TiledMazeAlgorithm::carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) {
+    const int cw = (maze.getWidth() - 1) / 2;
+    const int ch = (maze.getHeight() - 1) / 2;
+    if (cw == 0 || ch == 0) return;
+    const int kx = std::min(tilesPerSide, cw);
+    const int ky = std::min(tilesPerSide, ch);
+    const int tileCount = kx * ky;
+
+    // Seeds are drawn up front in tile order, so the maze depends only on
+    // gen and never on which thread carves which tile
+    std::vector<std::uint32_t> seeds(tileCount);
+    for (int t = 0; t < tileCount; ++t) seeds[t] = static_cast<std::uint32_t>(gen());
+
+    std::atomic<size_t> peakTileBytes(0);
+    pool.parallelFor(tileCount, [&](int t) {
+        const int tx = t % kx, ty = t / kx;
+        const int i0 = tileBegin(tx, cw, kx), i1 = tileBegin(tx + 1, cw, kx);
+        const int j0 = tileBegin(ty, ch, ky), j1 = tileBegin(ty + 1, ch, ky);
+        const int tw = i1 - i0, th = j1 - j0;
+
+        MazeGrid tile(2 * tw + 1, 2 * th + 1);
+        std::mt19937 tileGen(seeds[t]);
+        std::unique_ptr<MazeAlgorithm> algo = createMazeAlgorithm(inner);
+        algo->run(tile, 1, 1, tileGen);
+
+        // Copy the tile interior only: its border walls are shared with the
+        // neighbouring tiles and are already '#', so no two tiles write the
+        // same cell
+        for (int y = 1; y < 2 * th; ++y) {
+            std::memcpy(maze.row(2 * j0 + y) + 2 * i0 + 1, tile.row(y) + 1, 2 * tw - 1);
+        }
+
+        size_t bytes = tile.cellCount() + algo->getStats().peakAuxBytes;
+        size_t seen = peakTileBytes.load();
+        while (bytes > seen && !peakTileBytes.compare_exchange_weak(seen, bytes)) {}
+    });
+
+    // Random spanning tree over the tile grid (Kruskal). Edge id = tile * 2 +
+    // (0: seam to the right, 1: seam below). One opening per tree edge keeps
+    // the joined maze perfect.
+    std::vector<int> edges;
+    for (int t = 0; t < tileCount; ++t) {
+        if (t % kx + 1 < kx) edges.push_back(t * 2);
+        if (t / kx + 1 < ky) edges.push_back(t * 2 + 1);
+    }
+    std::shuffle(edges.begin(), edges.end(), gen);
+    std::vector<int> parent(tileCount);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    for (int e : edges) {
+        int a = e >> 1;
+        int b = (e & 1) ? a + kx : a + 1;
+        int ra = findTile(parent, a), rb = findTile(parent, b);
+        if (ra == rb) continue;
+        parent[rb] = ra;
+
+        const int tx = a % kx, ty = a / kx;
+        if (e & 1) {
+            // Horizontal seam below tile a: pick a column within the tile
+            int i0 = tileBegin(tx, cw, kx), i1 = tileBegin(tx + 1, cw, kx);
+            int i = std::uniform_int_distribution<int>(i0, i1 - 1)(gen);
+            maze(2 * i + 1, 2 * tileBegin(ty + 1, ch, ky)) = ' ';
+        } else {
+            // Vertical seam right of tile a: pick a row within the tile
+            int j0 = tileBegin(ty, ch, ky), j1 = tileBegin(ty + 1, ch, ky);
+            int j = std::uniform_int_distribution<int>(j0, j1 - 1)(gen);
+            maze(2 * tileBegin(tx + 1, cw, kx), 2 * j + 1) = ' ';
+        }
+    }
+
+    stats.peakAuxBytes = peakTileBytes.load() * pool.getThreadCount() +
+                         seeds.capacity() * sizeof(std::uint32_t);
+    if (hasTarget) pathByTreeWalk(maze, startX, startY);
+}
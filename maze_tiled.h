@@ -0,0 +1,31 @@
+#ifndef MAZE_TILED_H
+#define MAZE_TILED_H
+
+#include <random>
+#include "maze_algorithms.h"
+#include "thread_pool.h"
+
+// Parallel carving for large mazes. The carving cells are split into
+// tilesPerSide x tilesPerSide rectangular regions, each carved as its own
+// perfect maze by the inner strategy on the thread pool, with an RNG stream
+// seeded per tile from the caller's generator. The regions are then joined
+// by opening one random seam wall for every edge of a random spanning tree
+// over the tile grid, so the whole maze is still a single spanning tree.
+// For a fixed seed the result does not depend on the number of threads.
+class TiledMazeAlgorithm : public MazeAlgorithm {
+public:
+    TiledMazeAlgorithm(MazeAlgorithmType inner, int tilesPerSide, ThreadPool& pool);
+
+    MazeAlgorithmType getType() const override { return inner; }
+    int getTilesPerSide() const { return tilesPerSide; }
+
+protected:
+    void carve(MazeGrid& maze, int startX, int startY, std::mt19937& gen) override;
+
+private:
+    MazeAlgorithmType inner;
+    int tilesPerSide;
+    ThreadPool& pool;
+};
+
+#endif // MAZE_TILED_H
@@ -0,0 +1,33 @@
+#include "neighbor_masks.h"
+
+const int NeighborMasks::kDx[4] = {-1, 1, 0, 0};
+const int NeighborMasks::kDy[4] = {0, 0, -1, 1};
+
+const NeighborMasks::DirectionList NeighborMasks::kDirections[16] = {
+    {0, {0, 0, 0, 0}}, {1, {0, 0, 0, 0}}, {1, {1, 0, 0, 0}}, {2, {0, 1, 0, 0}},
+    {1, {2, 0, 0, 0}}, {2, {0, 2, 0, 0}}, {2, {1, 2, 0, 0}}, {3, {0, 1, 2, 0}},
+    {1, {3, 0, 0, 0}}, {2, {0, 3, 0, 0}}, {2, {1, 3, 0, 0}}, {3, {0, 1, 3, 0}},
+    {2, {2, 3, 0, 0}}, {3, {0, 2, 3, 0}}, {3, {1, 2, 3, 0}}, {4, {0, 1, 2, 3}},
+};
+
+NeighborMasks::NeighborMasks() : width(0), height(0) {}
+
+void NeighborMasks::build(const MazeGrid& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    masks.assign(maze.cellCount(), 0);
+    for (int y = 0; y < height; ++y) {
+        const char* row = maze.row(y);
+        const char* up = y > 0 ? maze.row(y - 1) : nullptr;
+        const char* down = y + 1 < height ? maze.row(y + 1) : nullptr;
+        std::uint8_t* out = &masks[static_cast<size_t>(y) * width];
+        for (int x = 0; x < width; ++x) {
+            std::uint8_t m = 0;
+            if (x > 0 && row[x - 1] != '#') m |= 1;
+            if (x + 1 < width && row[x + 1] != '#') m |= 2;
+            if (up && up[x] != '#') m |= 4;
+            if (down && down[x] != '#') m |= 8;
+            out[x] = m;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef NEIGHBOR_MASKS_H
+#define NEIGHBOR_MASKS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+
+// Open neighbours of every cell as a 4-bit mask, computed once per maze, so
+// ghost moves never rebuild neighbour lists. Bit d is set when the cell one
+// step in direction d (left, right, up, down) is inside the maze and not a
+// wall. directions(mask) lists the set bits in that order.
+class NeighborMasks {
+public:
+    static const int kDx[4];
+    static const int kDy[4];
+
+    struct DirectionList {
+        std::uint8_t count;
+        std::uint8_t dirs[4];
+    };
+
+    NeighborMasks();
+
+    void build(const MazeGrid& maze);
+    bool isBuiltFor(const MazeGrid& maze) const {
+        return width == maze.getWidth() && height == maze.getHeight() && !masks.empty();
+    }
+
+    // Caller guarantees (x, y) is inside the maze
+    std::uint8_t mask(int x, int y) const { return masks[static_cast<size_t>(y) * width + x]; }
+    static const DirectionList& directions(std::uint8_t mask) { return kDirections[mask & 15]; }
+
+private:
+    static const DirectionList kDirections[16];
+
+    int width, height;
+    std::vector<std::uint8_t> masks;
+};
+
+#endif // NEIGHBOR_MASKS_H
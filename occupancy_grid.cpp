@@ -0,0 +1,29 @@
+#include "occupancy_grid.h"
+
+namespace {
+const size_t kNoCell = static_cast<size_t>(-1);
+}
+
+OccupancyGrid::OccupancyGrid() : width(0), height(0), playerCell(kNoCell) {}
+
+void OccupancyGrid::reset(const MazeGrid& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    playerCell = kNoCell;
+    flags.assign(maze.cellCount(), 0);
+    ghosts.assign(maze.cellCount(), 0);
+}
+
+void OccupancyGrid::setChest(int x, int y, bool present) {
+    if (present) {
+        flags[cell(x, y)] |= CHEST;
+    } else {
+        flags[cell(x, y)] &= static_cast<std::uint8_t>(~CHEST);
+    }
+}
+
+void OccupancyGrid::setPlayer(int x, int y) {
+    if (playerCell != kNoCell) flags[playerCell] &= static_cast<std::uint8_t>(~PLAYER);
+    playerCell = cell(x, y);
+    flags[playerCell] |= PLAYER;
+}
@@ -0,0 +1,53 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+
+// What stands on each maze cell besides walls: chest and player flags plus a
+// ghost count (spawns may share a cell). Kept in step with the entities by
+// GhostManager (ghosts, player) and GameManager (chests), so collision
+// queries are O(1) instead of scans over the entity lists.
+class OccupancyGrid {
+public:
+    enum : std::uint8_t {
+        CHEST  = 1,
+        PLAYER = 2
+    };
+
+    OccupancyGrid();
+
+    // Clear everything and size the grid to the maze
+    void reset(const MazeGrid& maze);
+    bool isSizedFor(const MazeGrid& maze) const {
+        return width == maze.getWidth() && height == maze.getHeight() && !flags.empty();
+    }
+
+    void setChest(int x, int y, bool present);
+    // Moves the player flag; the previous cell is cleared
+    void setPlayer(int x, int y);
+    void addGhost(int x, int y) { ++ghosts[cell(x, y)]; }
+    void removeGhost(int x, int y) { --ghosts[cell(x, y)]; }
+    void moveGhost(int fromX, int fromY, int toX, int toY) {
+        removeGhost(fromX, fromY);
+        addGhost(toX, toY);
+    }
+
+    // Caller guarantees (x, y) is inside the maze
+    bool hasChest(int x, int y) const { return (flags[cell(x, y)] & CHEST) != 0; }
+    bool hasPlayer(int x, int y) const { return (flags[cell(x, y)] & PLAYER) != 0; }
+    bool hasGhost(int x, int y) const { return ghosts[cell(x, y)] != 0; }
+    int ghostCount(int x, int y) const { return ghosts[cell(x, y)]; }
+
+private:
+    int width, height;
+    size_t playerCell;                  // cell with the PLAYER flag, or npos
+    std::vector<std::uint8_t> flags;
+    std::vector<std::uint16_t> ghosts;
+
+    size_t cell(int x, int y) const { return static_cast<size_t>(y) * width + x; }
+};
+
+#endif // OCCUPANCY_GRID_H
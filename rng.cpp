@@ -0,0 +1,45 @@
+#include "rng.h"
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+
+// splitmix64 step: a full-avalanche 64-bit mix, so nearby seeds and stream
+// IDs still give unrelated generator states
+std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+std::uint64_t randomSeed() {
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+}
+
+std::mt19937 makeRng(std::uint64_t levelSeed, int stream, std::uint32_t index) {
+    std::uint64_t state = levelSeed ^ (static_cast<std::uint64_t>(stream) << 32 | index) * 0xD1B54A32D192ED03ull;
+    std::uint64_t a = splitmix64(state);
+    std::uint64_t b = splitmix64(state);
+    std::seed_seq seq{static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(a >> 32),
+                      static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(b >> 32)};
+    return std::mt19937(seq);
+}
+
+CompactRng makeCompactRng(std::uint64_t levelSeed, int stream, std::uint32_t index) {
+    std::uint64_t state = levelSeed ^ (static_cast<std::uint64_t>(stream) << 32 | index) * 0xD1B54A32D192ED03ull;
+    return CompactRng(splitmix64(state));
+}
+
+bool parseSeed(const std::string& text, std::uint64_t& seed) {
+    if (text.empty() || text[0] < '0' || text[0] > '9') return false;
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (errno == ERANGE || *end != '\0') return false;
+    seed = value;
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+// Deterministic randomness. A level is fully described by one 64-bit level
+// seed: every subsystem draws from its own stream derived from that seed and
+// a fixed stream ID, so extra draws in one subsystem never shift the numbers
+// another one sees, and the same seed always rebuilds the same level.
+enum RngStream {
+    RNG_MAZE = 1,       // carving and post-processing
+    RNG_CHESTS,         // chest placement
+    RNG_GHOST_SPAWNS,   // ghost spawn planning
+    RNG_GHOSTS,         // ghost movement, one sub-stream per ghost
+    RNG_EVENTS          // chest benefits
+};
+
+// Fresh seed from std::random_device, for levels started without --seed
+std::uint64_t randomSeed();
+
+// Generator for sub-stream `index` of `stream` under levelSeed
+std::mt19937 makeRng(std::uint64_t levelSeed, int stream, std::uint32_t index = 0);
+
+// Eight-byte generator (splitmix64) for swarms that need one stream per
+// entity, where a 5 KB mt19937 each would dominate memory and cache
+class CompactRng {
+public:
+    explicit CompactRng(std::uint64_t seed = 0) : state(seed) {}
+
+    std::uint32_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+    // Uniform in [0, n) by multiply-shift; n must be non-zero
+    std::uint32_t below(std::uint32_t n) {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(next()) * n) >> 32);
+    }
+
+private:
+    std::uint64_t state;
+};
+
+// Compact generator for sub-stream `index` of `stream` under levelSeed
+CompactRng makeCompactRng(std::uint64_t levelSeed, int stream, std::uint32_t index = 0);
+
+// Parses a decimal seed; false on anything else or on overflow
+bool parseSeed(const std::string& text, std::uint64_t& seed);
+
+#endif // RNG_H
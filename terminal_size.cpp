@@ -0,0 +1,84 @@
+#include "terminal_size.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+namespace {
+
+bool watching = false;
+TerminalSize lastSize = {0, 0};
+
+} // namespace
+
+bool queryTerminalSize(int fd, TerminalSize& size) {
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (handle == INVALID_HANDLE_VALUE || !GetConsoleScreenBufferInfo(handle, &info)) return false;
+    // The visible window, not the scrollback buffer behind it
+    size.cols = info.srWindow.Right - info.srWindow.Left + 1;
+    size.rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    return size.cols > 0 && size.rows > 0;
+}
+
+void watchTerminalResize() {
+    if (watching) return;
+    // No resize signal: the console's size is polled instead
+    if (!queryTerminalSize(1, lastSize)) lastSize = TerminalSize{0, 0};
+    watching = true;
+}
+
+bool terminalResized() {
+    if (!watching) return false;
+    TerminalSize size;
+    if (!queryTerminalSize(1, size) || (size.cols == lastSize.cols && size.rows == lastSize.rows)) return false;
+    lastSize = size;
+    return true;
+}
+
+#else
+
+namespace {
+
+volatile std::sig_atomic_t resizePending = 0;
+bool watching = false;
+
+void onResize(int) {
+    resizePending = 1;
+}
+
+} // namespace
+
+bool queryTerminalSize(int fd, TerminalSize& size) {
+    struct winsize ws;
+    if (ioctl(fd, TIOCGWINSZ, &ws) != 0 || ws.ws_col == 0 || ws.ws_row == 0) return false;
+    size.cols = ws.ws_col;
+    size.rows = ws.ws_row;
+    return true;
+}
+
+void watchTerminalResize() {
+    if (watching) return;
+    struct sigaction action;
+    action.sa_handler = onResize;
+    sigemptyset(&action.sa_mask);
+    // Restart interrupted reads so the input loop never sees EINTR
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &action, nullptr);
+    watching = true;
+}
+
+bool terminalResized() {
+    if (!resizePending) return false;
+    resizePending = 0;
+    return true;
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef TERMINAL_SIZE_H
+#define TERMINAL_SIZE_H
+
+// Size of the terminal in character cells
+struct TerminalSize {
+    int cols;
+    int rows;
+};
+
+// Asks the terminal behind fd (TIOCGWINSZ, or the console window on
+// Windows); false if fd is not a terminal or reports no size
+bool queryTerminalSize(int fd, TerminalSize& size);
+
+// Installs a SIGWINCH handler, once; terminalResized then tells whether the
+// terminal was resized since it was last asked. Windows has no such signal,
+// so there terminalResized compares the console's size with the last one.
+void watchTerminalResize();
+bool terminalResized();
+
+#endif // TERMINAL_SIZE_H
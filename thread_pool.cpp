@@ -0,0 +1,63 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+    : stopping(false), body(nullptr), count(0), next(0), loopId(0), busyWorkers(0) {
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::runTasks() {
+    for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+        (*body)(i);
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& body) {
+    if (count <= 0) return;
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->body = &body;
+        this->count = count;
+        next = 0;
+        busyWorkers = (int)workers.size();
+        loopId++;
+    }
+    wakeWorkers.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return busyWorkers == 0; });
+    this->body = nullptr;
+}
+
+void ThreadPool::workerLoop() {
+    unsigned seenLoop = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWorkers.wait(lock, [this, seenLoop] { return stopping || loopId != seenLoop; });
+        if (stopping) return;
+        seenLoop = loopId;
+        lock.unlock();
+
+        runTasks();
+
+        lock.lock();
+        if (--busyWorkers == 0) allDone.notify_one();
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. parallelFor hands out
+// indices one at a time from a shared counter, so uneven tasks balance
+// themselves, and the calling thread works alongside the pool.
+class ThreadPool {
+public:
+    // threadCount includes the calling thread; 1 runs everything inline
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    int getThreadCount() const { return (int)workers.size() + 1; }
+
+    // Runs body(i) for every i in [0, count) and returns once all are done.
+    // body must not throw. Not reentrant: one loop at a time per pool.
+    void parallelFor(int count, const std::function<void(int)>& body);
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    void workerLoop();
+    void runTasks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable allDone;
+    bool stopping;
+
+    // Current loop, published under mutex
+    const std::function<void(int)>* body;
+    int count;
+    std::atomic<int> next;
+    unsigned loopId;      // bumped per loop so workers join each one once
+    int busyWorkers;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,97 @@
+#include "timing_wheel.h"
+#include <algorithm>
+
+const int TimingWheel::kSlotMs;
+const int TimingWheel::kSlotCount;
+const std::uint32_t TimingWheel::kNone;
+
+TimingWheel::TimingWheel() : slotStartMs(0), count(0) {
+    clear(0);
+}
+
+void TimingWheel::clear(std::int64_t nowMs) {
+    std::fill(heads, heads + kSlotCount, kNone);
+    std::fill(tails, tails + kSlotCount, kNone);
+    next.clear();
+    prev.clear();
+    dueTimes.clear();
+    slotStartMs = nowMs - nowMs % kSlotMs;
+    count = 0;
+}
+
+void TimingWheel::schedule(std::uint32_t id, std::int64_t dueMs) {
+    if (id >= next.size()) {
+        next.resize(id + 1, kNone);
+        prev.resize(id + 1, kNone);
+        dueTimes.resize(id + 1, 0);
+    }
+    dueMs = std::max(dueMs, slotStartMs);
+    dueTimes[id] = dueMs;
+    next[id] = kNone;
+    int slot = slotOf(dueMs);
+    prev[id] = tails[slot];
+    if (tails[slot] == kNone) {
+        heads[slot] = id;
+    } else {
+        next[tails[slot]] = id;
+    }
+    tails[slot] = id;
+    ++count;
+}
+
+bool TimingWheel::popSlot(std::int64_t nowMs, std::vector<Entry>& due) {
+    if (slotStartMs > nowMs) return false;
+    if (count == 0) {
+        // Nothing waiting: skip the empty slots up to nowMs
+        slotStartMs = nowMs - nowMs % kSlotMs + kSlotMs;
+        return false;
+    }
+
+    // Take the ids due before the slot ends; later turns are relinked
+    due.clear();
+    const int slot = slotOf(slotStartMs);
+    const std::int64_t slotEndMs = slotStartMs + kSlotMs;
+    std::uint32_t keptHead = kNone, keptTail = kNone;
+    for (std::uint32_t id = heads[slot]; id != kNone;) {
+        std::uint32_t following = next[id];
+        if (dueTimes[id] < slotEndMs) {
+            due.push_back(Entry{id, dueTimes[id]});
+        } else {
+            next[id] = kNone;
+            prev[id] = keptTail;
+            if (keptTail == kNone) {
+                keptHead = id;
+            } else {
+                next[keptTail] = id;
+            }
+            keptTail = id;
+        }
+        id = following;
+    }
+    heads[slot] = keptHead;
+    tails[slot] = keptTail;
+    count -= due.size();
+    slotStartMs = slotEndMs;
+    return true;
+}
+
+void TimingWheel::reschedule(std::uint32_t id, std::int64_t dueMs) {
+    const int slot = slotOf(dueTimes[id]);
+    if (prev[id] == kNone) {
+        heads[slot] = next[id];
+    } else {
+        next[prev[id]] = next[id];
+    }
+    if (next[id] == kNone) {
+        tails[slot] = prev[id];
+    } else {
+        prev[next[id]] = prev[id];
+    }
+    --count;
+    schedule(id, dueMs);
+}
+
+size_t TimingWheel::memoryBytes() const {
+    return sizeof(heads) + sizeof(tails) + (next.capacity() + prev.capacity()) * sizeof(std::uint32_t) +
+           dueTimes.capacity() * sizeof(std::int64_t);
+}
@@ -0,0 +1,62 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ids waiting for a due time in game milliseconds. A ring of kSlotCount
+// slots, each kSlotMs of game time wide: scheduling appends the id to the
+// slot of its due time and advancing the clock empties one slot per kSlotMs,
+// so both cost O(1) per id that is actually due however many are waiting.
+// Due times further out than one turn of the ring wait in their slot for
+// the right turn. Slots are doubly linked lists threaded through per-id
+// arrays, so scheduling never allocates once an id has been seen and a
+// waiting id can be moved without searching its slot.
+class TimingWheel {
+public:
+    static const int kSlotMs = 100;     // due times are rounded down to this
+    static const int kSlotCount = 64;   // one turn: 6.4 s of game time
+
+    struct Entry {
+        std::uint32_t id;
+        std::int64_t dueMs;
+    };
+
+    TimingWheel();
+
+    // Drop every id and restart the clock at nowMs
+    void clear(std::int64_t nowMs);
+    // An id waits for one due time at a time; due times before the current
+    // slot are moved up to it
+    void schedule(std::uint32_t id, std::int64_t dueMs);
+    // Moves the ids of the next slot starting at or before nowMs to due
+    // (which is cleared first), in the order they were scheduled, and steps
+    // the clock past that slot. Returns false, leaving due untouched, once
+    // the clock has caught up with nowMs.
+    bool popSlot(std::int64_t nowMs, std::vector<Entry>& due);
+    // Move a waiting id to a new due time in O(1); the id must be waiting
+    void reschedule(std::uint32_t id, std::int64_t dueMs);
+    // Due time of a waiting id
+    std::int64_t getDueMs(std::uint32_t id) const { return dueTimes[id]; }
+
+    // Start of the next slot to pop
+    std::int64_t getTimeMs() const { return slotStartMs; }
+    size_t size() const { return count; }
+    size_t memoryBytes() const;
+
+private:
+    static const std::uint32_t kNone = UINT32_MAX;
+
+    std::uint32_t heads[kSlotCount];    // first and last id of each slot
+    std::uint32_t tails[kSlotCount];
+    std::vector<std::uint32_t> next;    // by id: the ids before and after it in its slot
+    std::vector<std::uint32_t> prev;
+    std::vector<std::int64_t> dueTimes; // by id
+    std::int64_t slotStartMs;
+    size_t count;
+
+    static int slotOf(std::int64_t ms) { return static_cast<int>((ms / kSlotMs) % kSlotCount); }
+};
+
+#endif // TIMING_WHEEL_H
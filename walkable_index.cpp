@@ -0,0 +1,37 @@
+#include "walkable_index.h"
+
+const std::uint32_t WalkableIndex::kAbsent;
+
+WalkableIndex::WalkableIndex() : width(0), height(0) {}
+
+void WalkableIndex::build(const MazeGrid& maze) {
+    width = maze.getWidth();
+    height = maze.getHeight();
+    cells.clear();
+    slot.assign(maze.cellCount(), kAbsent);
+    const char* data = maze.data();
+    for (size_t i = 0; i < maze.cellCount(); ++i) {
+        if (data[i] != ' ') continue;
+        slot[i] = static_cast<std::uint32_t>(cells.size());
+        cells.push_back(static_cast<std::uint32_t>(i));
+    }
+}
+
+void WalkableIndex::insert(int x, int y) {
+    size_t c = cell(x, y);
+    if (slot[c] != kAbsent) return;
+    slot[c] = static_cast<std::uint32_t>(cells.size());
+    cells.push_back(static_cast<std::uint32_t>(c));
+}
+
+void WalkableIndex::erase(int x, int y) {
+    size_t c = cell(x, y);
+    std::uint32_t s = slot[c];
+    if (s == kAbsent) return;
+    // Swap the last cell into the hole
+    std::uint32_t last = cells.back();
+    cells[s] = last;
+    slot[last] = s;
+    cells.pop_back();
+    slot[c] = kAbsent;
+}
@@ -0,0 +1,54 @@
+#ifndef WALKABLE_INDEX_H
+#define WALKABLE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "maze_grid.h"
+#include "pos.h"
+
+// The free floor cells of one level: open, and not holding a chest. Built
+// once per level and shared by chest placement, ghost spawning and
+// teleports. Cells sit in a dense array with a per-cell slot back into it,
+// so insert, erase and uniform random sampling are all O(1).
+class WalkableIndex {
+public:
+    WalkableIndex();
+    explicit WalkableIndex(const MazeGrid& maze) : WalkableIndex() { build(maze); }
+
+    // Every ' ' cell of the maze
+    void build(const MazeGrid& maze);
+    bool isBuiltFor(const MazeGrid& maze) const {
+        return width == maze.getWidth() && height == maze.getHeight() && !slot.empty();
+    }
+
+    // Both are no-ops when the cell is already in / already out
+    void insert(int x, int y);
+    void erase(int x, int y);
+    bool contains(int x, int y) const { return slot[cell(x, y)] != kAbsent; }
+
+    size_t size() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+
+    // The i-th free cell, i < size(); order changes with every insert/erase
+    pos at(size_t i) const {
+        return pos{static_cast<int>(cells[i] % width), static_cast<int>(cells[i] / width)};
+    }
+    // Uniformly random free cell; caller guarantees !empty()
+    pos sample(std::mt19937& gen) const {
+        std::uint32_t c = cells[std::uniform_int_distribution<size_t>(0, cells.size() - 1)(gen)];
+        return pos{static_cast<int>(c % width), static_cast<int>(c / width)};
+    }
+
+private:
+    static const std::uint32_t kAbsent = UINT32_MAX;
+
+    int width, height;
+    std::vector<std::uint32_t> cells;   // free cells, in no particular order
+    std::vector<std::uint32_t> slot;    // position of each cell in cells, or kAbsent
+
+    size_t cell(int x, int y) const { return static_cast<size_t>(y) * width + x; }
+};
+
+#endif // WALKABLE_INDEX_H